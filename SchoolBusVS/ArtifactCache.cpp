@@ -0,0 +1,86 @@
+#include "ArtifactCache.h"
+#include "MappedFile.h"
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
+
+ArtifactCache::ArtifactCache(const string& path) : directory(path) {
+	error_code error;
+	filesystem::create_directories(directory, error);
+	if (error)
+		cout << "Warning: couldn't create cache directory " << directory << endl;
+}
+
+string ArtifactCache::getPath(const string& kind, unsigned long long key) const {
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", key);
+	return (filesystem::path(directory) / (kind + "-" + name)).string();
+}
+
+PathMatrix ArtifactCache::getPathMatrix(Graph& graph, const vector<int>& poiIDs, unsigned numThreads) const {
+	shared_ptr<ContractionHierarchy> hierarchy = make_shared<ContractionHierarchy>(getContractionHierarchy(graph, numThreads));
+	return ContractionHierarchy::getPathMatrix(hierarchy, poiIDs);
+}
+
+ContractionHierarchy ArtifactCache::getContractionHierarchy(Graph& graph, unsigned numThreads) const {
+	graph.finalize();
+	string path = getPath("ch", hashGraph(graph));
+
+	ContractionHierarchy hierarchy(graph);
+	if (hierarchy.load(path))
+		return hierarchy;
+	hierarchy.build(numThreads);
+	if (!hierarchy.save(path))
+		cout << "Warning: couldn't write " << path << endl;
+	return hierarchy;
+}
+
+/*** Hashing ***/
+
+// Final mix of splitmix64, so that every input bit affects every output bit
+static unsigned long long mix(unsigned long long h) {
+	h ^= h >> 30;
+	h *= 0xBF58476D1CE4E5B9ULL;
+	h ^= h >> 27;
+	h *= 0x94D049BB133111EBULL;
+	return h ^ (h >> 31);
+}
+
+unsigned long long ArtifactCache::hashBytes(const void* data, size_t size, unsigned long long seed) {
+	const unsigned long long MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+	const char* p = (const char*)data;
+	unsigned long long h = mix(seed ^ size);
+	// Eight bytes at a time, so that hashing the graph files costs much less than parsing them
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		unsigned long long word;
+		memcpy(&word, p + i, 8);
+		h = (h ^ (word * MULTIPLIER)) * MULTIPLIER;
+		h ^= h >> 32;
+	}
+	unsigned long long tail = 0;
+	if (i < size)
+		memcpy(&tail, p + i, size - i);
+	return mix(h ^ (tail * MULTIPLIER));
+}
+
+unsigned long long ArtifactCache::hashFile(const string& path) {
+	MappedFile file(path);
+	if (!file.isOpen())
+		return hashBytes(NULL, 0);
+	return hashBytes(file.begin(), file.size());
+}
+
+unsigned long long ArtifactCache::hashGraph(const Graph& graph) {
+	vector<int> ids(graph.getNumVertex());
+	for (size_t i = 0; i < ids.size(); i++)
+		ids[i] = graph.getVertexSet()[i]->getID();
+	unsigned long long h = hashBytes(ids.data(), ids.size() * sizeof(int));
+	h = hashBytes(graph.getCSROffsets().data(), graph.getCSROffsets().size() * sizeof(unsigned), h);
+	h = hashBytes(graph.getCSRTargets().data(), graph.getCSRTargets().size() * sizeof(unsigned), h);
+	return hashBytes(graph.getCSRWeights().data(), graph.getCSRWeights().size() * sizeof(double), h);
+}
+
+unsigned long long ArtifactCache::combine(unsigned long long key, unsigned long long value) {
+	return mix(key ^ mix(value + 0x9E3779B97F4A7C15ULL));
+}
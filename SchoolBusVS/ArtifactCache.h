@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include "Graph.h"
+#include "ContractionHierarchy.h"
+
+using namespace std;
+
+/**
+ * Directory of preprocessing artifacts (graph snapshots, contraction hierarchies) named by a key of
+ * what they were made from. The keys hash the contents of the inputs, so an artifact is reused as long as its
+ * inputs are byte for byte the same, whatever their modification times, and a change in any input simply
+ * leads to another file. Each artifact validates its own format when it's read, and is written atomically.
+ */
+class ArtifactCache {
+	string directory;
+public:
+	/**
+	 * Uses the directory at path, creating it if needed.
+	 */
+	ArtifactCache(const string& path);
+
+	/**
+	 * Path of the artifact of the given kind ("graph", "ch", ...) made from the inputs with the given key.
+	 */
+	string getPath(const string& kind, unsigned long long key) const;
+
+	/**
+	 * Shortest paths between every pair of the PoIs in graph, with the distances of the contraction hierarchy
+	 * of the graph (see getContractionHierarchy and ContractionHierarchy::getPathMatrix). Only the hierarchy is
+	 * stored: the distance table takes a few milliseconds, and the paths are unpacked when they're used.
+	 */
+	PathMatrix getPathMatrix(Graph& graph, const vector<int>& poiIDs, unsigned numThreads = 1) const;
+
+	/**
+	 * Contraction hierarchy of graph, read from the cache if the same graph was seen before; otherwise built
+	 * (on numThreads threads) and stored.
+	 */
+	ContractionHierarchy getContractionHierarchy(Graph& graph, unsigned numThreads = 1) const;
+
+	static unsigned long long hashBytes(const void* data, size_t size, unsigned long long seed = 0);
+
+	// Hash of the contents of a file (a missing file hashes like an empty one)
+	static unsigned long long hashFile(const string& path);
+
+	// Key of the searchable contents of a finalized graph: vertex IDs and the CSR arrays
+	static unsigned long long hashGraph(const Graph& graph);
+
+	// Key of a value derived from key and value (order matters)
+	static unsigned long long combine(unsigned long long key, unsigned long long value);
+};
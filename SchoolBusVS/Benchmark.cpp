@@ -0,0 +1,645 @@
+#include "Benchmark.h"
+#include "GraphBuilder.h"
+#include "CompactGraph.h"
+#include "SearchAlgorithms.h"
+#include "GraphSnapshot.h"
+#include "StreamingGraphBuilder.h"
+#include "Geometry.h"
+#include "GraphCatalog.h"
+#include "ArtifactCache.h"
+#include "PoIList.h"
+#include "ContractionHierarchy.h"
+#include "OneToAllSweep.h"
+
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <filesystem>
+#include <thread>
+
+static double elapsedMs(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Random vertex IDs, always the same ones for the same graph and seed
+static vector<int> randomVertexIDs(const Graph& graph, int count, unsigned seed) {
+	vector<int> ids;
+	vector<int> all;
+	for (Vertex* v : graph.getVertexSet())
+		all.push_back(v->getID());
+	sort(all.begin(), all.end());
+	mt19937 rng(seed);
+	uniform_int_distribution<size_t> pick(0, all.size() - 1);
+	for (int i = 0; i < count && !all.empty(); i++)
+		ids.push_back(all[pick(rng)]);
+	return ids;
+}
+
+// Time of running Dijkstra from every source with the given queue, on the given adjacency
+template <class Queue, class Adjacency, class Weight>
+static double timeDijkstra(const Adjacency& adjacency, const Graph& graph, const vector<int>& sources, BasicSearchContext<Weight>& context) {
+	auto start = chrono::steady_clock::now();
+	for (int id : sources)
+		search::dijkstra<Queue>(adjacency, graph.findVertex(id)->getIndex(), context);
+	return elapsedMs(start);
+}
+
+void benchmark::vertexOrder(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries) {
+	const GraphBuilder::VertexOrder orders[] = { GraphBuilder::InputOrder, GraphBuilder::HilbertOrder, GraphBuilder::BFSOrder };
+	const char* names[] = { "Input", "Hilbert", "BFS" };
+
+	out << "Dijkstra, " << numQueries << " queries on " << nodeFilePath << endl;
+	out << setw(10) << "Order" << setw(14) << "Build (ms)" << setw(16) << "Queries (ms)" << setw(16) << "Per query (ms)" << endl;
+	for (int i = 0; i < 3; i++) {
+		auto start = chrono::steady_clock::now();
+		unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).setVertexOrder(orders[i]).build();
+		double buildTime = elapsedMs(start);
+		if (graph->getNumVertex() == 0)
+			return;
+
+		vector<int> sources = randomVertexIDs(*graph, numQueries, 2019);
+		SearchContext context;
+		start = chrono::steady_clock::now();
+		for (int id : sources)
+			graph->dijkstraShortestPath(id, context);
+		double queryTime = elapsedMs(start);
+
+		out << setw(10) << names[i] << fixed << setprecision(2) << setw(14) << buildTime
+			<< setw(16) << queryTime << setw(16) << queryTime / sources.size() << endl;
+	}
+}
+
+void benchmark::compactGraph(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries) {
+	unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).build();
+	if (graph->getNumEdges() == 0)
+		return;
+	CompactGraph compact(*graph);
+	vector<int> sources = randomVertexIDs(*graph, numQueries, 2019);
+
+	SearchContext context;
+	auto start = chrono::steady_clock::now();
+	for (int id : sources)
+		graph->dijkstraShortestPath(id, context);
+	double graphTime = elapsedMs(start);
+
+	start = chrono::steady_clock::now();
+	for (int id : sources)
+		compact.dijkstraShortestPath(id, context);
+	double compactTime = elapsedMs(start);
+
+	size_t numEdges = graph->getNumEdges();
+	out << "Graph vs CompactGraph on " << edgeFilePath << " (" << graph->getNumVertex() << " vertices, " << numEdges << " edges)" << endl;
+	out << setw(14) << "" << setw(14) << "Bytes" << setw(16) << "Bytes / edge" << setw(16) << "Per query (ms)" << endl;
+	out << fixed << setprecision(2);
+	out << setw(14) << "Graph" << setw(14) << graph->getMemoryUsage() << setw(16) << (double)graph->getMemoryUsage() / numEdges
+		<< setw(16) << graphTime / sources.size() << endl;
+	out << setw(14) << "CompactGraph" << setw(14) << compact.getMemoryUsage() << setw(16) << (double)compact.getMemoryUsage() / numEdges
+		<< setw(16) << compactTime / sources.size() << endl;
+}
+
+void benchmark::searchKernels(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries) {
+	unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).build();
+	if (graph->getNumEdges() == 0)
+		return;
+	CSRGraph<float> floatGraph = CSRGraph<float>::fromGraph(*graph);
+	CSRGraph<unsigned> fixedGraph = CSRGraph<unsigned>::fromGraph(*graph, CompactGraph::WEIGHT_SCALE);
+	vector<int> sources = randomVertexIDs(*graph, numQueries, 2019);
+
+	SearchContext doubleContext;
+	BasicSearchContext<float> floatContext;
+	BasicSearchContext<unsigned> fixedContext;
+	const char* names[] = { "double", "double", "float", "float", "fixed point", "fixed point" };
+	double times[] = {
+		timeDijkstra<IndexedPriorityQueue<double>>(*graph, *graph, sources, doubleContext),
+		timeDijkstra<LazyPriorityQueue<double>>(*graph, *graph, sources, doubleContext),
+		timeDijkstra<IndexedPriorityQueue<float>>(floatGraph, *graph, sources, floatContext),
+		timeDijkstra<LazyPriorityQueue<float>>(floatGraph, *graph, sources, floatContext),
+		timeDijkstra<IndexedPriorityQueue<unsigned>>(fixedGraph, *graph, sources, fixedContext),
+		timeDijkstra<LazyPriorityQueue<unsigned>>(fixedGraph, *graph, sources, fixedContext)
+	};
+
+	out << "Dijkstra kernels, " << numQueries << " queries on " << nodeFilePath << endl;
+	out << setw(14) << "Weight" << setw(10) << "Queue" << setw(16) << "Per query (ms)" << endl;
+	out << fixed << setprecision(3);
+	for (int i = 0; i < 6; i++)
+		out << setw(14) << names[i] << setw(10) << (i % 2 == 0 ? "Indexed" : "Lazy") << setw(16) << times[i] / sources.size() << endl;
+}
+
+void benchmark::pointToPoint(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries) {
+	unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).build();
+	if (graph->getNumEdges() == 0)
+		return;
+	vector<int> sources = randomVertexIDs(*graph, numQueries, 2019);
+
+	// Each target is drawn among the vertices reached from its source: an unreachable target makes A* settle
+	// the whole component of the source, like Dijkstra
+	SearchContext context;
+	mt19937 rng(2020);
+	vector<int> targets;
+	vector<double> dists;
+	size_t dijkstraSettled = 0, aStarSettled = 0;
+	double dijkstraTime = 0;
+	for (int source : sources) {
+		auto start = chrono::steady_clock::now();
+		graph->dijkstraShortestPath(source, context);
+		dijkstraTime += elapsedMs(start);
+		vector<unsigned> reached;
+		for (unsigned v = 0; v < context.dist.size(); v++) {
+			if (context.dist[v] != INF)
+				reached.push_back(v);
+		}
+		unsigned target = reached[uniform_int_distribution<size_t>(0, reached.size() - 1)(rng)];
+		targets.push_back(graph->getVertexSet()[target]->getID());
+		dists.push_back(context.dist[target]);
+		dijkstraSettled += reached.size();
+	}
+
+	int mismatches = 0;
+	auto start = chrono::steady_clock::now();
+	for (size_t i = 0; i < sources.size(); i++) {
+		aStarSettled += graph->aStarShortestPath(sources[i], targets[i], context);
+		double dist = context.dist[graph->findVertex(targets[i])->getIndex()];
+		if (abs(dist - dists[i]) > 1e-9 * dists[i])
+			mismatches++;
+	}
+	double aStarTime = elapsedMs(start);
+
+	BidirectionalContext bidirectional;
+	size_t bidirectionalSettled[2] = { 0, 0 };
+	double bidirectionalTimes[2];
+	for (int heuristic = 0; heuristic < 2; heuristic++) {
+		start = chrono::steady_clock::now();
+		for (size_t i = 0; i < sources.size(); i++) {
+			if (heuristic)
+				graph->bidirectionalAStar(sources[i], targets[i], bidirectional);
+			else graph->bidirectionalDijkstra(sources[i], targets[i], bidirectional);
+			bidirectionalSettled[heuristic] += bidirectional.settled;
+			if (abs(bidirectional.dist - dists[i]) > 1e-9 * dists[i])
+				mismatches++;
+		}
+		bidirectionalTimes[heuristic] = elapsedMs(start);
+	}
+
+	out << "Point to point queries, " << sources.size() << " connected pairs on " << nodeFilePath
+		<< " (heuristic scale " << fixed << setprecision(3) << graph->getHeuristicScale() << ")" << endl;
+	out << setw(16) << "" << setw(18) << "Settled per query" << setw(16) << "Per query (ms)" << endl;
+	out << setw(16) << "Dijkstra" << setw(18) << dijkstraSettled / sources.size() << setw(16) << dijkstraTime / sources.size() << endl;
+	out << setw(16) << "A*" << setw(18) << aStarSettled / sources.size() << setw(16) << aStarTime / sources.size() << endl;
+	out << setw(16) << "Bidir. Dijkstra" << setw(18) << bidirectionalSettled[0] / sources.size() << setw(16) << bidirectionalTimes[0] / sources.size() << endl;
+	out << setw(16) << "Bidir. A*" << setw(18) << bidirectionalSettled[1] / sources.size() << setw(16) << bidirectionalTimes[1] / sources.size() << endl;
+	if (mismatches > 0)
+		out << "Warning: " << mismatches << " distances differ from Dijkstra's" << endl;
+}
+
+// Number of pairs of a small path of zero weight edges (vertices at the same place) where a ContractionHierarchy
+// and Dijkstra disagree: contracting a vertex between two zero weight edges must still add the shortcut
+static int zeroWeightMismatches() {
+	Graph graph;
+	for (int id = 1; id <= 5; id++)
+		graph.addVertex(id, 0, 0);
+	for (int id = 1; id < 5; id++) {
+		graph.addEdge(2 * id, id, id + 1, 0);
+		graph.addEdge(2 * id + 1, id + 1, id, 0);
+	}
+	graph.finalize();
+	ContractionHierarchy hierarchy(graph);
+	hierarchy.build();
+	SearchContext context;
+	BidirectionalContext bidirectional;
+	int mismatches = 0;
+	for (int src = 1; src <= 5; src++) {
+		graph.dijkstraShortestPath(src, context);
+		for (int dest = 1; dest <= 5; dest++) {
+			if (hierarchy.query(src, dest, bidirectional) != context.dist[graph.findVertex(dest)->getIndex()])
+				mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+void benchmark::contractionHierarchy(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries, unsigned maxThreads) {
+	unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).build();
+	if (graph->getNumEdges() == 0)
+		return;
+	string path = (filesystem::temp_directory_path() / "benchmark.ch").string();
+
+	out << "Contraction hierarchy of " << edgeFilePath << " (" << graph->getNumVertex() << " vertices, "
+		<< graph->getNumEdges() << " edges)" << endl;
+	out << setw(10) << "Threads" << setw(16) << "Build (ms)" << setw(12) << "Shortcuts" << endl;
+	ContractionHierarchy hierarchy(*graph);
+	for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+		auto start = chrono::steady_clock::now();
+		hierarchy.build(threads);
+		out << setw(10) << threads << setw(16) << fixed << setprecision(1) << elapsedMs(start) << setw(12) << hierarchy.getNumShortcuts() << endl;
+	}
+	auto start = chrono::steady_clock::now();
+	if (!hierarchy.save(path))
+		return;
+	double saveTime = elapsedMs(start);
+	start = chrono::steady_clock::now();
+	ContractionHierarchy loaded(*graph);
+	bool valid = loaded.load(path);
+	double loadTime = elapsedMs(start);
+	filesystem::remove(path);
+	if (!valid)
+		return;
+	out << "Memory: " << loaded.getMemoryUsage() / 1024 << " KB, save: " << saveTime << " ms, load: " << loadTime << " ms" << endl;
+
+	// Connected pairs, as in pointToPoint
+	vector<int> sources = randomVertexIDs(*graph, numQueries, 2019), targets;
+	vector<double> dists;
+	SearchContext context;
+	mt19937 rng(2020);
+	for (int source : sources) {
+		graph->dijkstraShortestPath(source, context);
+		vector<unsigned> reached;
+		for (unsigned v = 0; v < context.dist.size(); v++) {
+			if (context.dist[v] != INF)
+				reached.push_back(v);
+		}
+		unsigned target = reached[uniform_int_distribution<size_t>(0, reached.size() - 1)(rng)];
+		targets.push_back(graph->getVertexSet()[target]->getID());
+		dists.push_back(context.dist[target]);
+	}
+
+	BidirectionalContext bidirectional;
+	size_t settled[2] = { 0, 0 };
+	double times[3];
+	int mismatches = 0;
+	for (int kind = 0; kind < 3; kind++) {
+		start = chrono::steady_clock::now();
+		for (size_t i = 0; i < sources.size(); i++) {
+			double dist;
+			if (kind == 0) {
+				graph->bidirectionalDijkstra(sources[i], targets[i], bidirectional);
+				dist = bidirectional.dist;
+			}
+			else dist = loaded.query(sources[i], targets[i], bidirectional);
+			if (kind == 2 && loaded.getPath(bidirectional).empty())
+				mismatches++;
+			if (kind < 2)
+				settled[kind] += bidirectional.settled;
+			if (abs(dist - dists[i]) > 1e-9 * dists[i])
+				mismatches++;
+		}
+		times[kind] = elapsedMs(start);
+	}
+	out << setw(24) << "" << setw(18) << "Settled per query" << setw(16) << "Per query (ms)" << endl;
+	out << setw(24) << "Bidirectional Dijkstra" << setw(18) << settled[0] / sources.size() << setw(16) << setprecision(4) << times[0] / sources.size() << endl;
+	out << setw(24) << "Hierarchy" << setw(18) << settled[1] / sources.size() << setw(16) << times[1] / sources.size() << endl;
+	out << setw(24) << "Hierarchy + path" << setw(18) << settled[1] / sources.size() << setw(16) << times[2] / sources.size() << endl;
+	if (mismatches > 0)
+		out << "Warning: " << mismatches << " distances or paths differ from Dijkstra's" << endl;
+	int zeroWeight = zeroWeightMismatches();
+	if (zeroWeight > 0)
+		out << "Warning: " << zeroWeight << " distances differ from Dijkstra's on a path of zero weight edges" << endl;
+}
+
+void benchmark::manyToMany(ostream& out, const string& nodeFilePath, const string& edgeFilePath, const vector<int>& sizes) {
+	unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).build();
+	if (graph->getNumEdges() == 0)
+		return;
+	auto start = chrono::steady_clock::now();
+	shared_ptr<ContractionHierarchy> hierarchy = make_shared<ContractionHierarchy>(*graph);
+	hierarchy->build(max(thread::hardware_concurrency(), 1u));
+	out << "Many to many distances on " << edgeFilePath << " (hierarchy built in " << fixed << setprecision(1) << elapsedMs(start) << " ms)" << endl;
+	out << setw(8) << "K" << setw(16) << "Dijkstras (ms)" << setw(14) << "Buckets (ms)" << setw(22) << "multipleDijkstra (ms)"
+		<< setw(20) << "Lazy matrix (ms)" << endl;
+
+	SearchContext context;
+	for (int k : sizes) {
+		vector<int> ids = randomVertexIDs(*graph, k, 2019);
+		vector<unsigned> indexes;
+		for (int id : ids)
+			indexes.push_back(graph->findVertex(id)->getIndex());
+
+		start = chrono::steady_clock::now();
+		vector<double> expected;
+		expected.reserve(indexes.size() * indexes.size());
+		for (unsigned s : indexes) {
+			search::dijkstra<IndexedPriorityQueue<double>>(*graph, s, context);
+			for (unsigned t : indexes)
+				expected.push_back(context.dist[t]);
+		}
+		double dijkstraTime = elapsedMs(start);
+
+		start = chrono::steady_clock::now();
+		vector<double> table = hierarchy->distanceTable(indexes, indexes);
+		double bucketTime = elapsedMs(start);
+		int mismatches = 0;
+		for (size_t i = 0; i < table.size(); i++) {
+			if (table[i] != expected[i] && abs(table[i] - expected[i]) > 1e-9 * expected[i])
+				mismatches++;
+		}
+
+		double eagerTime = -1;
+		if (k <= 500) {
+			start = chrono::steady_clock::now();
+			PathMatrix eager = graph->multipleDijkstra(ids);
+			eagerTime = elapsedMs(start);
+		}
+		start = chrono::steady_clock::now();
+		PathMatrix lazy = ContractionHierarchy::getPathMatrix(hierarchy, ids);
+		double lazyTime = elapsedMs(start);
+
+		out << setw(8) << k << setw(16) << dijkstraTime << setw(14) << bucketTime;
+		if (eagerTime >= 0)
+			out << setw(22) << eagerTime;
+		else out << setw(22) << "-";
+		out << setw(20) << lazyTime << endl;
+		if (mismatches > 0)
+			out << "Warning: " << mismatches << " distances differ from Dijkstra's" << endl;
+	}
+}
+
+void benchmark::oneToAll(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numSources) {
+	unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).build();
+	if (graph->getNumEdges() == 0)
+		return;
+	ContractionHierarchy hierarchy(*graph);
+	hierarchy.build(max(thread::hardware_concurrency(), 1u));
+	auto start = chrono::steady_clock::now();
+	OneToAllSweep sweep(hierarchy);
+	double setupTime = elapsedMs(start);
+	vector<unsigned> sources;
+	for (int id : randomVertexIDs(*graph, numSources, 2019))
+		sources.push_back(graph->findVertex(id)->getIndex());
+	size_t numVertices = graph->getNumVertex();
+
+	SearchContext context;
+	vector<double> expected;
+	expected.reserve(sources.size() * numVertices);
+	start = chrono::steady_clock::now();
+	for (unsigned s : sources) {
+		search::dijkstra<IndexedPriorityQueue<double>>(*graph, s, context);
+		expected.insert(expected.end(), context.dist.begin(), context.dist.end());
+	}
+	double dijkstraTime = elapsedMs(start);
+
+	start = chrono::steady_clock::now();
+	vector<double> single;
+	single.reserve(sources.size() * numVertices);
+	for (unsigned s : sources) {
+		vector<double> row = sweep.distancesFrom(s);
+		single.insert(single.end(), row.begin(), row.end());
+	}
+	double singleTime = elapsedMs(start);
+
+	start = chrono::steady_clock::now();
+	vector<double> batched = sweep.distanceRows(sources);
+	double batchedTime = elapsedMs(start);
+
+	int mismatches = 0;
+	for (size_t i = 0; i < expected.size(); i++) {
+		for (double d : { single[i], batched[i] }) {
+			if (d != expected[i] && abs(d - expected[i]) > 1e-9 * expected[i])
+				mismatches++;
+		}
+	}
+
+	size_t rows = max<size_t>(sources.size(), 1);
+	out << "One to all distances on " << edgeFilePath << " from " << sources.size() << " sources (sweep order set up in "
+		<< fixed << setprecision(1) << setupTime << " ms)" << endl;
+	out << setw(24) << "Method" << setw(16) << "Total (ms)" << setw(14) << "Per row (ms)" << endl;
+	out << setprecision(3);
+	out << setw(24) << "Dijkstra" << setw(16) << dijkstraTime << setw(14) << dijkstraTime / rows << endl;
+	out << setw(24) << "Sweep" << setw(16) << singleTime << setw(14) << singleTime / rows << endl;
+	out << setw(24) << ("Sweep x" + to_string(OneToAllSweep::SWEEP_WIDTH)) << setw(16) << batchedTime << setw(14) << batchedTime / rows << endl;
+	if (mismatches > 0)
+		out << "Warning: " << mismatches << " distances differ from Dijkstra's" << endl;
+}
+
+void benchmark::snapshot(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries) {
+	string path = (filesystem::temp_directory_path() / "benchmark.snapshot").string();
+
+	auto start = chrono::steady_clock::now();
+	unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).build();
+	double textTime = elapsedMs(start);
+	if (graph->getNumVertex() == 0)
+		return;
+	start = chrono::steady_clock::now();
+	if (!GraphSnapshot::write(*graph, path, 0))
+		return;
+	double writeTime = elapsedMs(start);
+	vector<int> sources = randomVertexIDs(*graph, numQueries, 2019);
+	vector<unsigned> indexes;
+	for (int id : sources)
+		indexes.push_back(graph->findVertex(id)->getIndex());
+
+	SearchContext context;
+	double mapTime, mappedQueryTime, rebuildTime;
+	{
+		start = chrono::steady_clock::now();
+		GraphSnapshot snapshot(path);
+		mapTime = elapsedMs(start);
+		start = chrono::steady_clock::now();
+		for (unsigned s : indexes)
+			search::dijkstra<IndexedPriorityQueue<double>>(snapshot, s, context);
+		mappedQueryTime = elapsedMs(start);
+
+		start = chrono::steady_clock::now();
+		unique_ptr<Graph> rebuilt = snapshot.toGraph();
+		rebuildTime = elapsedMs(start);
+	}
+	start = chrono::steady_clock::now();
+	for (int id : sources)
+		graph->dijkstraShortestPath(id, context);
+	double queryTime = elapsedMs(start);
+	filesystem::remove(path);
+
+	out << "Text files vs GraphSnapshot on " << edgeFilePath << " (write: " << fixed << setprecision(2) << writeTime << " ms)" << endl;
+	out << setw(22) << "" << setw(12) << "Load (ms)" << setw(16) << "Per query (ms)" << endl;
+	out << setw(22) << "Text files" << setw(12) << textTime << setw(16) << queryTime / sources.size() << endl;
+	out << setw(22) << "Snapshot (mapped)" << setw(12) << mapTime << setw(16) << mappedQueryTime / sources.size() << endl;
+	out << setw(22) << "Snapshot (to Graph)" << setw(12) << rebuildTime + mapTime << setw(16) << queryTime / sources.size() << endl;
+}
+
+void benchmark::parsingThreads(ostream& out, const string& nodeFilePath, const string& edgeFilePath, unsigned maxThreads) {
+	out << "Text graph build with N threads on " << edgeFilePath << endl;
+	out << setw(10) << "Threads" << setw(14) << "Build (ms)" << setw(12) << "Speedup" << endl;
+	double singleThreadTime = 0;
+	for (unsigned threads = 1; threads <= maxThreads; threads++) {
+		double best = INF;
+		for (int run = 0; run < 3; run++) {
+			auto start = chrono::steady_clock::now();
+			unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).setNumThreads(threads).build();
+			best = min(best, elapsedMs(start));
+			if (graph->getNumVertex() == 0)
+				return;
+		}
+		if (threads == 1)
+			singleThreadTime = best;
+		out << setw(10) << threads << fixed << setprecision(2) << setw(14) << best << setw(12) << singleThreadTime / best << endl;
+	}
+}
+
+void benchmark::streamingIngest(ostream& out, const string& nodeFilePath, const string& edgeFilePath) {
+	string path = (filesystem::temp_directory_path() / "benchmark.snapshot").string();
+
+	out << "Snapshot of " << edgeFilePath << endl;
+	out << setw(24) << "" << setw(14) << "Time (ms)" << endl;
+	auto start = chrono::steady_clock::now();
+	{
+		unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).build();
+		if (graph->getNumVertex() == 0 || !GraphSnapshot::write(*graph, path, 0))
+			return;
+	}
+	out << setw(24) << "GraphBuilder" << fixed << setprecision(2) << setw(14) << elapsedMs(start) << endl;
+
+	for (size_t megabytes : { 4, 16, 64 }) {
+		start = chrono::steady_clock::now();
+		if (!StreamingGraphBuilder(nodeFilePath, edgeFilePath, megabytes << 20).build(path))
+			return;
+		out << setw(16) << "Streaming, " << setw(3) << megabytes << " MB" << setw(14) << elapsedMs(start) << endl;
+	}
+	filesystem::remove(path);
+}
+
+// Sum of the weights of every edge of the graph
+static double totalWeight(const Graph& graph) {
+	double total = 0;
+	for (double weight : graph.getCSRWeights())
+		total += weight;
+	return total;
+}
+
+void benchmark::geodesicWeights(ostream& out, const string& nodeFilePath, const string& edgeFilePath, const string& latLonFilePath) {
+	unique_ptr<Graph> planar = GraphBuilder(nodeFilePath, edgeFilePath).build();
+	unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).setLatLonFilePath(latLonFilePath).build();
+	if (!graph->hasGeoCoordinates())
+		return;
+
+	size_t numVertices = graph->getNumVertex();
+	vector<double> lats(numVertices), lons(numVertices);
+	for (unsigned v = 0; v < numVertices; v++) {
+		lats[v] = graph->getLat(v);
+		lons[v] = graph->getLon(v);
+	}
+	const vector<unsigned>& offsets = graph->getCSROffsets();
+	const vector<unsigned>& dest = graph->getCSRTargets();
+	vector<unsigned> src(dest.size());
+	for (unsigned v = 0; v < numVertices; v++)
+		fill(src.begin() + offsets[v], src.begin() + offsets[v + 1], v);
+
+	vector<double> batch(dest.size()), haversine(dest.size());
+	double batchTime = INF, haversineTime = INF;
+	for (int run = 0; run < 5; run++) {
+		auto start = chrono::steady_clock::now();
+		geometry::geodesicLengths(lats.data(), lons.data(), numVertices, src.data(), dest.data(), batch.data(), batch.size());
+		batchTime = min(batchTime, elapsedMs(start));
+
+		start = chrono::steady_clock::now();
+		const double toRadians = 3.14159265358979323846 / 180;
+		for (size_t e = 0; e < dest.size(); e++) {
+			double lat1 = lats[src[e]] * toRadians, lat2 = lats[dest[e]] * toRadians;
+			double sinLat = sin((lat2 - lat1) / 2), sinLon = sin((lons[dest[e]] - lons[src[e]]) * toRadians / 2);
+			double h = sinLat * sinLat + cos(lat1) * cos(lat2) * sinLon * sinLon;
+			haversine[e] = 2 * geometry::EARTH_RADIUS * asin(sqrt(h));
+		}
+		haversineTime = min(haversineTime, elapsedMs(start));
+	}
+	double maxError = 0;
+	for (size_t e = 0; e < batch.size(); e++) {
+		if (haversine[e] > 0)
+			maxError = max(maxError, fabs(batch[e] - haversine[e]) / haversine[e]);
+	}
+
+	out << "Geodesic edge lengths on " << edgeFilePath << " (" << dest.size() << " edges)" << endl;
+	out << setw(24) << "" << setw(14) << "Time (ms)" << endl;
+	out << setw(24) << "geodesicLengths" << fixed << setprecision(3) << setw(14) << batchTime << endl;
+	out << setw(24) << "Haversine per edge" << setw(14) << haversineTime << endl;
+	out << "Max relative difference: " << scientific << setprecision(2) << maxError << fixed << endl;
+	out << "Total road length: " << setprecision(1) << totalWeight(*graph) / 2 << " m (X/Y: " << totalWeight(*planar) / 2 << " m)" << endl;
+}
+
+void benchmark::graphCatalog(ostream& out, const string& graphsDirectory, size_t memoryBudget, int numRounds) {
+	GraphCatalog catalog(graphsDirectory, memoryBudget);
+	const vector<string>& cities = catalog.getCityNames();
+	if (cities.empty())
+		return;
+
+	double residentTime = 0, loadingTime = 0;
+	int residentBatches = 0, loadingBatches = 0;
+	SearchContext context;
+	for (int round = 0; round < numRounds; round++) {
+		for (const string& name : cities) {
+			bool resident = catalog.isResident(name);
+			auto start = chrono::steady_clock::now();
+			shared_ptr<const CityGraph> city = catalog.get(name);
+			if (city == NULL)
+				continue;
+			for (int id : randomVertexIDs(*city->graph, 10, 2019 + round))
+				city->graph->dijkstraShortestPath(id, context);
+			if (resident) {
+				residentTime += elapsedMs(start);
+				residentBatches++;
+			}
+			else {
+				loadingTime += elapsedMs(start);
+				loadingBatches++;
+			}
+		}
+	}
+
+	out << "GraphCatalog of " << cities.size() << " cities, " << (memoryBudget >> 20) << " MB budget, 10 queries per batch" << endl;
+	out << setw(22) << "" << setw(10) << "Batches" << setw(20) << "Per batch (ms)" << endl;
+	out << fixed << setprecision(2);
+	out << setw(22) << "City resident" << setw(10) << residentBatches << setw(20) << (residentBatches ? residentTime / residentBatches : 0) << endl;
+	out << setw(22) << "City loaded" << setw(10) << loadingBatches << setw(20) << (loadingBatches ? loadingTime / loadingBatches : 0) << endl;
+	out << "Loads: " << catalog.getNumLoads() << ", evictions: " << catalog.getNumEvictions()
+		<< ", resident: " << catalog.getResidentMemory() / (1 << 20) << " MB" << endl;
+}
+
+void benchmark::artifactCache(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numPoIs) {
+	filesystem::path directory = filesystem::temp_directory_path() / "benchmark-cache";
+	filesystem::remove_all(directory);
+	ArtifactCache cache(directory.string());
+
+	out << "Startup with an ArtifactCache on " << edgeFilePath << " (" << numPoIs << " PoIs)" << endl;
+	out << setw(10) << "" << setw(14) << "Graph (ms)" << setw(14) << "Matrix (ms)" << endl;
+	for (string start : { "Cold", "Warm" }) {
+		auto begin = chrono::steady_clock::now();
+		unique_ptr<Graph> graph = GraphBuilder(nodeFilePath, edgeFilePath).setVertexOrder(GraphBuilder::BFSOrder).setArtifactCache(cache).build();
+		double graphTime = elapsedMs(begin);
+		if (graph->getNumVertex() == 0)
+			break;
+		vector<int> pois = randomVertexIDs(*graph, numPoIs, 2019);
+		begin = chrono::steady_clock::now();
+		PathMatrix matrix = cache.getPathMatrix(*graph, pois);
+		out << setw(10) << start << fixed << setprecision(2) << setw(14) << graphTime << setw(14) << elapsedMs(begin) << endl;
+	}
+	filesystem::remove_all(directory);
+}
+
+void benchmark::regionOfInterest(ostream& out, const string& nodeFilePath, const string& edgeFilePath, const string& poiFilePath) {
+	vector<int> pois = PoIList::readIDs(poiFilePath);
+	sort(pois.begin(), pois.end());
+	pois.erase(unique(pois.begin(), pois.end()), pois.end());
+	unique_ptr<Graph> full = GraphBuilder(nodeFilePath, edgeFilePath).build();
+	if (full->getNumVertex() == 0 || pois.empty())
+		return;
+	auto start = chrono::steady_clock::now();
+	PathMatrix fullMatrix = full->multipleDijkstra(pois);
+	double fullTime = elapsedMs(start);
+
+	out << "Region of interest around the " << pois.size() << " PoIs of " << poiFilePath << " on " << edgeFilePath << endl;
+	out << setw(14) << "Padding (m)" << setw(10) << "Vertices" << setw(14) << "Memory (KB)" << setw(14) << "Matrix (ms)" << setw(16) << "Max dist error" << endl;
+	out << setw(14) << "Whole graph" << setw(10) << full->getNumVertex() << setw(14) << full->getMemoryUsage() / 1024
+		<< fixed << setprecision(2) << setw(14) << fullTime << setw(15) << 0.0 << "%" << endl;
+	for (double padding : { 250.0, 500.0, 1000.0, 2000.0 }) {
+		unique_ptr<Graph> region = GraphBuilder(nodeFilePath, edgeFilePath).setRegionOfInterest(pois, padding).build();
+		start = chrono::steady_clock::now();
+		PathMatrix matrix = region->multipleDijkstra(pois);
+		double time = elapsedMs(start);
+		double maxError = 0;
+		for (int src : pois) {
+			for (int dest : pois) {
+				double exact = fullMatrix.getDist(src, dest);
+				if (exact > 0 && exact != INF)
+					maxError = max(maxError, matrix.getDist(src, dest) / exact - 1);
+			}
+		}
+		out << setw(14) << padding << setw(10) << region->getNumVertex() << setw(14) << region->getMemoryUsage() / 1024
+			<< setw(14) << time << setw(15) << maxError * 100 << "%" << endl;
+	}
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Timing experiments over the graph files. Results are printed as plain text tables.
+ */
+namespace benchmark {
+	/**
+	 * Times the same Dijkstra queries on the graph built with each GraphBuilder::VertexOrder.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param numQueries Number of random sources
+	 */
+	void vertexOrder(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries);
+
+	/**
+	 * Compares the memory used per edge, and Dijkstra times, of Graph and CompactGraph.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param numQueries Number of random sources
+	 */
+	void compactGraph(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries);
+
+	/**
+	 * Times the same Dijkstra queries with each weight type (double, float, fixed point) and queue
+	 * (IndexedPriorityQueue with decrease-key, LazyPriorityQueue without it).
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param numQueries Number of random sources
+	 */
+	void searchKernels(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries);
+
+	/**
+	 * Compares a full Dijkstra with A*, bidirectional Dijkstra and bidirectional A* on random connected source/target
+	 * pairs: settled vertices and time per query.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param numQueries Number of random pairs
+	 */
+	void pointToPoint(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries);
+
+	/**
+	 * Times building a ContractionHierarchy with 1 to maxThreads threads, saving and loading it, and its queries
+	 * (with and without unpacking the path) against bidirectional Dijkstra on random connected pairs.
+	 * The hierarchy is saved to a temporary file. Also checks the queries on a small path of zero weight edges.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param numQueries Number of random pairs
+	 * @param maxThreads Largest number of preprocessing threads tried
+	 */
+	void contractionHierarchy(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries, unsigned maxThreads);
+
+	/**
+	 * Times K x K distance tables of random vertices: K Dijkstra searches against the bucket table of a
+	 * ContractionHierarchy, and filling a PathMatrix with Graph::multipleDijkstra (up to K = 500) against
+	 * ContractionHierarchy::getPathMatrix, which leaves the paths to be unpacked when used.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param sizes Values of K
+	 */
+	void manyToMany(ostream& out, const string& nodeFilePath, const string& edgeFilePath, const vector<int>& sizes);
+
+	/**
+	 * Times full distance rows (from a source to every vertex) of random sources: a Dijkstra per source against
+	 * OneToAllSweep, one source per sweep and OneToAllSweep::SWEEP_WIDTH sources per sweep.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param numSources Number of random sources
+	 */
+	void oneToAll(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numSources);
+
+	/**
+	 * Compares loading a graph from the text files with loading it from a GraphSnapshot, both mapped
+	 * as is (searched in place) and rebuilt into a Graph (what GraphBuilder::build does with a snapshot).
+	 * The snapshot is written to a temporary file.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param numQueries Number of random sources
+	 */
+	void snapshot(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numQueries);
+
+	/**
+	 * Times building a graph from the text files with 1 to maxThreads parsing threads (best of a few runs each).
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param maxThreads Largest number of threads tried
+	 */
+	void parsingThreads(ostream& out, const string& nodeFilePath, const string& edgeFilePath, unsigned maxThreads);
+
+	/**
+	 * Times making a GraphSnapshot with GraphBuilder and with StreamingGraphBuilder under a few memory budgets.
+	 * The snapshots are written to temporary files.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 */
+	void streamingIngest(ostream& out, const string& nodeFilePath, const string& edgeFilePath);
+
+	/**
+	 * Times the geodesic edge lengths of GraphBuilder::setLatLonFilePath against a haversine per edge,
+	 * and compares the total length of the roads with the X/Y euclidean one.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param latLonFilePath Lat/lon file (T05_nodes_lat_lon_*.txt)
+	 */
+	void geodesicWeights(ostream& out, const string& nodeFilePath, const string& edgeFilePath, const string& latLonFilePath);
+
+	/**
+	 * Routes random queries in the cities of a GraphCatalog, switching city after each batch, and reports the
+	 * time of the batches served by resident cities and by loading ones, with the loads and evictions.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param graphsDirectory Directory with a subdirectory per city
+	 * @param memoryBudget Memory budget of the catalog, in bytes
+	 * @param numRounds Number of times every city is visited
+	 */
+	void graphCatalog(ostream& out, const string& graphsDirectory, size_t memoryBudget, int numRounds);
+
+	/**
+	 * Times a cold start (empty ArtifactCache) and a warm one (the same inputs again): building the graph
+	 * and the path matrix of random PoIs. The cache is kept in a temporary directory.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param numPoIs Number of random PoIs
+	 */
+	void artifactCache(ostream& out, const string& nodeFilePath, const string& edgeFilePath, int numPoIs);
+
+	/**
+	 * Compares the whole graph with the regions of interest around the PoIs of a PoI file, with a few paddings:
+	 * size, memory, time of the PoI path matrix and largest relative error of its distances.
+	 *
+	 * @param out Stream where the results are printed
+	 * @param nodeFilePath Node file (T05_nodes_X_Y_*.txt)
+	 * @param edgeFilePath Edge file (T05_edges_*.txt)
+	 * @param poiFilePath PoI file (as Files/pois.txt)
+	 */
+	void regionOfInterest(ostream& out, const string& nodeFilePath, const string& edgeFilePath, const string& poiFilePath);
+}
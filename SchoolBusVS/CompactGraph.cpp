@@ -0,0 +1,79 @@
+#include "CompactGraph.h"
+#include "SearchAlgorithms.h"
+
+void CompactGraph::writeVarint(vector<unsigned char>& out, unsigned value) {
+	while (value >= 0x80) {
+		out.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((unsigned char)value);
+}
+
+CompactGraph::CompactGraph(const Graph& graph) {
+	const vector<Vertex*>& vertexSet = graph.getVertexSet();
+	const vector<unsigned>& csrOffsets = graph.getCSROffsets();
+	const vector<unsigned>& csrTargets = graph.getCSRTargets();
+	const vector<double>& csrWeights = graph.getCSRWeights();
+
+	ids.resize(vertexSet.size());
+	idToIndex.reserve(vertexSet.size());
+	for (Vertex* v : vertexSet) {
+		ids[v->getIndex()] = v->getID();
+		idToIndex[v->getID()] = v->getIndex();
+	}
+
+	offsets.resize(vertexSet.size() + 1);
+	data.reserve(csrTargets.size() * 4);
+	vector<pair<unsigned, unsigned>> edges;	// (dest, fixed point weight) of one vertex
+	for (unsigned v = 0; v < vertexSet.size(); v++) {
+		offsets[v] = (unsigned)data.size();
+		edges.clear();
+		for (unsigned e = csrOffsets[v]; e < csrOffsets[v + 1]; e++) {
+			double w = csrWeights[e] * WEIGHT_SCALE + 0.5;
+			edges.push_back(make_pair(csrTargets[e], w < 4294967295.0 ? (unsigned)w : 4294967295u));
+		}
+		sort(edges.begin(), edges.end());
+		numEdges += edges.size();
+
+		unsigned previous = v;
+		for (size_t i = 0; i < edges.size(); i++) {
+			if (i == 0) {
+				int delta = (int)(edges[i].first - v);
+				writeVarint(data, ((unsigned)delta << 1) ^ (unsigned)(delta >> 31));	// zigzag encoding
+			}
+			else writeVarint(data, edges[i].first - previous);
+			writeVarint(data, edges[i].second);
+			previous = edges[i].first;
+		}
+	}
+	offsets[vertexSet.size()] = (unsigned)data.size();
+	data.shrink_to_fit();
+}
+
+int CompactGraph::findIndex(int ID) const {
+	const unsigned* index = idToIndex.find(ID);
+	return index == NULL ? -1 : (int)*index;
+}
+
+size_t CompactGraph::getMemoryUsage() const {
+	return sizeof(CompactGraph) + offsets.capacity() * sizeof(unsigned) + data.capacity()
+		+ ids.capacity() * sizeof(int) + idToIndex.memoryUsage();
+}
+
+/*** Breadth First Search***/
+
+void CompactGraph::BFS(unsigned s, SearchContext& context) const {
+	search::bfs(*this, s, context);
+}
+
+/*** Dijkstra ***/
+
+void CompactGraph::dijkstraShortestPath(int sourceID, SearchContext& context) const {
+	int src = findIndex(sourceID);
+	if (src == -1) {
+		context.reset(ids.size());
+		cout << "Warning... Dijkstra shortest path from NULL." << endl;
+		return;
+	}
+	search::dijkstra<IndexedPriorityQueue<double>>(*this, src, context);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Graph.h"
+
+/**
+ * Read-only copy of a Graph with a compressed adjacency encoding, so that several large graphs can stay in memory.
+ * The neighbours of each vertex are sorted and stored as varint deltas (the first one relative to the vertex itself,
+ * zigzag encoded), each one followed by the edge weight as a varint in fixed point (1 / WEIGHT_SCALE units).
+ */
+class CompactGraph {
+	vector<unsigned> offsets;		// byte offset of the edges of each vertex in data
+	vector<unsigned char> data;
+	vector<int> ids;				// vertex ID of each dense index
+	FlatHashMap<int, unsigned> idToIndex;
+	size_t numEdges = 0;
+
+	static void writeVarint(vector<unsigned char>& out, unsigned value);
+	static unsigned readVarint(const unsigned char*& p);
+public:
+	static const unsigned WEIGHT_SCALE = 100;	// centimetres, for weights in metres
+
+	CompactGraph(const Graph& graph);
+
+	size_t getNumVertex() const { return ids.size(); }
+	size_t getNumEdges() const { return numEdges; }
+	int getID(unsigned index) const { return ids[index]; }
+	int findIndex(int ID) const;	// -1 if there's no such vertex
+	size_t getMemoryUsage() const;	// approximate heap usage, in bytes
+
+	/**
+	 * Calls visit(dest, weight) for every outgoing edge of vertex v (dense indexes).
+	 */
+	template <class Visitor>
+	void forEachEdge(unsigned v, Visitor visit) const;
+
+	void BFS(unsigned s, SearchContext& context) const;
+	void dijkstraShortestPath(int sourceID, SearchContext& context) const;
+};
+
+inline unsigned CompactGraph::readVarint(const unsigned char*& p) {
+	unsigned value = 0;
+	unsigned shift = 0;
+	while (*p & 0x80) {
+		value |= (unsigned)(*p++ & 0x7F) << shift;
+		shift += 7;
+	}
+	value |= (unsigned)(*p++) << shift;
+	return value;
+}
+
+template <class Visitor>
+void CompactGraph::forEachEdge(unsigned v, Visitor visit) const {
+	const unsigned char* p = data.data() + offsets[v];
+	const unsigned char* end = data.data() + offsets[v + 1];
+	if (p == end)
+		return;
+	unsigned first = readVarint(p);
+	unsigned dest = v + ((first & 1) ? ~(first >> 1) : (first >> 1));	// zigzag decoding
+	visit(dest, (double)readVarint(p) / WEIGHT_SCALE);
+	while (p != end) {
+		dest += readVarint(p);
+		visit(dest, (double)readVarint(p) / WEIGHT_SCALE);
+	}
+}
@@ -0,0 +1,547 @@
+#include "ContractionHierarchy.h"
+#include "ThreadPool.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <memory>
+#include <cstring>
+#include <cstdio>
+
+static const char MAGIC[8] = "SBCHIER";
+
+// Witness searches give up after settling this many vertices (a missed witness only costs an extra shortcut)
+static const int WITNESS_SETTLED_LIMIT = 500;
+
+/*** Preprocessing ***/
+
+namespace {
+	// A shortcut from -> to through the contracted vertex middle (-1 for an edge of the graph)
+	struct Shortcut {
+		unsigned from, to;
+		double weight;
+		int middle;
+	};
+
+	// The graph left to contract: the arcs between vertices that haven't been contracted yet
+	struct RemainingGraph {
+		vector<vector<ContractionHierarchy::Arc>> out, in;
+		vector<char> contracting;	// contracted in the current round, so the witness searches avoid them
+
+		/**
+		 * Dijkstra from source that doesn't enter excluded or the vertices being contracted, and stops after
+		 * settling WITNESS_SETTLED_LIMIT vertices or passing maxDist. Other distances are only upper bounds.
+		 */
+		void witnessSearch(unsigned source, unsigned excluded, double maxDist, SearchContext& context) const {
+			context.reset(out.size());
+			context.dist[source] = 0;
+			context.touch(source);
+			IndexedPriorityQueue<double> queue(context.dist, context.queueIndex);
+			queue.insert(source);
+			for (int settled = 0; !queue.empty() && settled < WITNESS_SETTLED_LIMIT; settled++) {
+				unsigned v = queue.extractMin();
+				double dist = context.dist[v];
+				if (dist > maxDist)
+					break;
+				for (const ContractionHierarchy::Arc& arc : out[v]) {
+					unsigned w = arc.vertex;
+					if (w == excluded || contracting[w] || context.dist[w] <= dist + arc.weight)
+						continue;
+					bool queued = context.dist[w] != INF;
+					context.dist[w] = dist + arc.weight;
+					if (!queued) {
+						context.touch(w);
+						queue.insert(w);
+					}
+					else queue.decreaseKey(w);
+				}
+			}
+		}
+
+		// Shortcuts needed to contract v: one for each pair of neighbours u -> v -> w without a witness as short
+		void findShortcuts(unsigned v, SearchContext& context, vector<Shortcut>& shortcuts) const {
+			shortcuts.clear();
+			for (const ContractionHierarchy::Arc& first : in[v]) {
+				double maxDist = -1;	// stays negative if first.vertex is v's only neighbour (arcs can weigh 0)
+				for (const ContractionHierarchy::Arc& second : out[v]) {
+					if (second.vertex != first.vertex)
+						maxDist = max(maxDist, first.weight + second.weight);
+				}
+				if (maxDist < 0)
+					continue;
+				witnessSearch(first.vertex, v, maxDist, context);
+				for (const ContractionHierarchy::Arc& second : out[v]) {
+					double weight = first.weight + second.weight;
+					if (second.vertex != first.vertex && context.dist[second.vertex] > weight)
+						shortcuts.push_back({ first.vertex, second.vertex, weight, (int)v });
+				}
+			}
+		}
+
+		// Removes the arc from -> to from both lists
+		void removeArc(unsigned from, unsigned to) {
+			auto erase = [](vector<ContractionHierarchy::Arc>& arcs, unsigned vertex) {
+				for (size_t i = 0; i < arcs.size(); i++) {
+					if (arcs[i].vertex == vertex) {
+						arcs[i] = arcs.back();
+						arcs.pop_back();
+						return;
+					}
+				}
+			};
+			erase(out[from], to);
+			erase(in[to], from);
+		}
+
+		// Adds the arc, or shortens the arc it replaces (keeping a shorter arc as it is)
+		void addShortcut(const Shortcut& shortcut) {
+			for (ContractionHierarchy::Arc& arc : out[shortcut.from]) {
+				if (arc.vertex != shortcut.to)
+					continue;
+				if (arc.weight <= shortcut.weight)
+					return;
+				arc.weight = shortcut.weight;
+				arc.middle = shortcut.middle;
+				for (ContractionHierarchy::Arc& reverse : in[shortcut.to]) {
+					if (reverse.vertex == shortcut.from) {
+						reverse.weight = shortcut.weight;
+						reverse.middle = shortcut.middle;
+					}
+				}
+				return;
+			}
+			out[shortcut.from].push_back({ shortcut.weight, shortcut.to, shortcut.middle });
+			in[shortcut.to].push_back({ shortcut.weight, shortcut.from, shortcut.middle });
+		}
+	};
+}
+
+// Appends the arcs of every vertex, in order, as CSR arrays
+static void toCSR(const vector<vector<ContractionHierarchy::Arc>>& arcs, vector<unsigned>& offsets, vector<ContractionHierarchy::Arc>& flat) {
+	offsets.assign(arcs.size() + 1, 0);
+	for (size_t v = 0; v < arcs.size(); v++)
+		offsets[v + 1] = offsets[v] + (unsigned)arcs[v].size();
+	flat.clear();
+	flat.reserve(offsets.back());
+	for (const vector<ContractionHierarchy::Arc>& list : arcs)
+		flat.insert(flat.end(), list.begin(), list.end());
+}
+
+void ContractionHierarchy::build(unsigned numThreads) {
+	size_t numVertices = graph->getNumVertex();
+	const vector<unsigned>& offsets = graph->getCSROffsets();
+	const vector<unsigned>& targets = graph->getCSRTargets();
+	const vector<double>& weights = graph->getCSRWeights();
+
+	RemainingGraph remaining;
+	remaining.out.resize(numVertices);
+	remaining.in.resize(numVertices);
+	remaining.contracting.assign(numVertices, false);
+	for (unsigned v = 0; v < numVertices; v++) {
+		for (unsigned e = offsets[v]; e < offsets[v + 1]; e++) {
+			if (targets[e] != v)	// loops are never part of a shortest path
+				remaining.addShortcut({ v, targets[e], weights[e], -1 });
+		}
+	}
+
+	numThreads = max(numThreads, 1u);
+	unique_ptr<ThreadPool> pool;
+	if (numThreads > 1)
+		pool.reset(new ThreadPool(numThreads));
+	vector<SearchContext> contexts(numThreads);
+	vector<vector<Shortcut>> shortcutBuffers(numThreads);
+
+	// Priority: edge difference (shortcuts added - arcs removed) + neighbours already contracted
+	vector<int> priority(numVertices, 0), deletedNeighbours(numVertices, 0);
+	auto updatePriorities = [&](const vector<unsigned>& vertices) {
+		forEachChunk(pool.get(), numThreads, [&](size_t chunk) {
+			for (size_t i = chunk; i < vertices.size(); i += numThreads) {
+				unsigned v = vertices[i];
+				remaining.findShortcuts(v, contexts[chunk], shortcutBuffers[chunk]);
+				int edgeDifference = (int)shortcutBuffers[chunk].size() - (int)remaining.in[v].size() - (int)remaining.out[v].size();
+				priority[v] = edgeDifference + deletedNeighbours[v];
+			}
+		});
+	};
+
+	vector<unsigned> left(numVertices);
+	for (unsigned v = 0; v < numVertices; v++)
+		left[v] = v;
+	updatePriorities(left);
+
+	vector<vector<Arc>> forward(numVertices), backward(numVertices);
+	rank.assign(numVertices, 0);
+	unsigned nextRank = 0;
+	vector<char> contracted(numVertices, false), dirty(numVertices, false);
+	while (!left.empty()) {
+		// Contract the vertices that come before all their neighbours, which are independent of each other
+		auto before = [&](unsigned v, unsigned u) { return priority[v] < priority[u] || (priority[v] == priority[u] && v < u); };
+		vector<unsigned> selected;
+		for (unsigned v : left) {
+			bool first = true;
+			for (const Arc& arc : remaining.out[v])
+				first = first && before(v, arc.vertex);
+			for (const Arc& arc : remaining.in[v])
+				first = first && before(v, arc.vertex);
+			if (first) {
+				selected.push_back(v);
+				remaining.contracting[v] = true;
+			}
+		}
+
+		vector<vector<Shortcut>> shortcuts(selected.size());
+		forEachChunk(pool.get(), numThreads, [&](size_t chunk) {
+			for (size_t i = chunk; i < selected.size(); i += numThreads)
+				remaining.findShortcuts(selected[i], contexts[chunk], shortcuts[i]);
+		});
+
+		vector<unsigned> neighbours;
+		for (size_t i = 0; i < selected.size(); i++) {
+			unsigned v = selected[i];
+			rank[v] = nextRank++;
+			contracted[v] = true;
+			remaining.contracting[v] = false;
+			forward[v] = remaining.out[v];
+			backward[v] = remaining.in[v];
+			for (const Arc& arc : forward[v]) {
+				remaining.removeArc(v, arc.vertex);
+				neighbours.push_back(arc.vertex);
+			}
+			for (const Arc& arc : backward[v]) {
+				remaining.removeArc(arc.vertex, v);
+				neighbours.push_back(arc.vertex);
+			}
+			for (const Shortcut& shortcut : shortcuts[i])
+				remaining.addShortcut(shortcut);
+		}
+
+		vector<unsigned> changed;
+		for (unsigned u : neighbours) {
+			deletedNeighbours[u]++;
+			if (!dirty[u]) {
+				dirty[u] = true;
+				changed.push_back(u);
+			}
+		}
+		for (unsigned u : changed)
+			dirty[u] = false;
+		updatePriorities(changed);
+		left.erase(remove_if(left.begin(), left.end(), [&](unsigned v) { return contracted[v]; }), left.end());
+	}
+
+	toCSR(forward, forwardOffsets, forwardArcs);
+	toCSR(backward, backwardOffsets, backwardArcs);
+	auto isShortcut = [](const Arc& arc) { return arc.middle >= 0; };
+	numShortcuts = count_if(forwardArcs.begin(), forwardArcs.end(), isShortcut) + count_if(backwardArcs.begin(), backwardArcs.end(), isShortcut);
+}
+
+/*** Queries ***/
+
+double ContractionHierarchy::query(int sourceID, int targetID, BidirectionalContext& context) const {
+	context.meeting = -1;
+	context.dist = INF;
+	context.settled = 0;
+	context.forward.reset(rank.size());
+	context.backward.reset(rank.size());
+	Vertex* src = graph->findVertex(sourceID);
+	Vertex* target = graph->findVertex(targetID);
+	if (src == NULL || target == NULL) {
+		cout << "Warning... Contraction hierarchy query from or to NULL." << endl;
+		return INF;
+	}
+
+	SearchContext* sides[] = { &context.forward, &context.backward };
+	unsigned starts[] = { src->getIndex(), target->getIndex() };
+	IndexedPriorityQueue<double> forwardQueue(context.forward.dist, context.forward.queueIndex);
+	IndexedPriorityQueue<double> backwardQueue(context.backward.dist, context.backward.queueIndex);
+	IndexedPriorityQueue<double>* queues[] = { &forwardQueue, &backwardQueue };
+	bool done[] = { false, false };
+	for (int side = 0; side < 2; side++) {
+		sides[side]->dist[starts[side]] = 0;
+		sides[side]->touch(starts[side]);
+		queues[side]->insert(starts[side]);
+	}
+
+	for (int side = 0; !done[0] || !done[1]; side ^= 1) {
+		if (done[side])
+			continue;
+		SearchContext& self = *sides[side];
+		const SearchContext& other = *sides[side ^ 1];
+		IndexedPriorityQueue<double>& queue = *queues[side];
+		if (queue.empty()) {
+			done[side] = true;
+			continue;
+		}
+		unsigned v = queue.extractMin();
+		double dist = self.dist[v];
+		if (dist >= context.dist) {	// nothing left on this side can lead to a shorter path
+			done[side] = true;
+			continue;
+		}
+		self.visited[v] = true;
+		context.settled++;
+		if (other.dist[v] != INF && dist + other.dist[v] < context.dist) {
+			context.dist = dist + other.dist[v];
+			context.meeting = v;
+		}
+		if (!isStalled(v, side == 0, self))
+			relaxUp(v, side == 0, self, queue);
+	}
+	return context.dist;
+}
+
+// Stall on demand: whether v is reached more cheaply through a higher ranked vertex, so its arcs can wait
+bool ContractionHierarchy::isStalled(unsigned v, bool forward, const SearchContext& context) const {
+	const vector<unsigned>& offsets = forward ? backwardOffsets : forwardOffsets;
+	const vector<Arc>& arcs = forward ? backwardArcs : forwardArcs;
+	for (unsigned a = offsets[v]; a < offsets[v + 1]; a++) {
+		if (context.dist[arcs[a].vertex] + arcs[a].weight < context.dist[v])
+			return true;
+	}
+	return false;
+}
+
+// Relaxes the arcs from v to higher ranked vertices (the incoming ones when !forward)
+void ContractionHierarchy::relaxUp(unsigned v, bool forward, SearchContext& context, IndexedPriorityQueue<double>& queue) const {
+	const vector<unsigned>& offsets = forward ? forwardOffsets : backwardOffsets;
+	const vector<Arc>& arcs = forward ? forwardArcs : backwardArcs;
+	double dist = context.dist[v];
+	for (unsigned a = offsets[v]; a < offsets[v + 1]; a++) {
+		unsigned w = arcs[a].vertex;
+		if (context.dist[w] <= dist + arcs[a].weight)
+			continue;
+		bool queued = context.dist[w] != INF;
+		context.dist[w] = dist + arcs[a].weight;
+		context.path[w] = v;
+		if (!queued) {
+			context.touch(w);
+			queue.insert(w);
+		}
+		else queue.decreaseKey(w);
+	}
+}
+
+void ContractionHierarchy::upwardSearch(unsigned start, bool forward, SearchContext& context, vector<unsigned>& settled) const {
+	settled.clear();
+	context.reset(rank.size());
+	context.dist[start] = 0;
+	context.touch(start);
+	IndexedPriorityQueue<double> queue(context.dist, context.queueIndex);
+	queue.insert(start);
+	while (!queue.empty()) {
+		unsigned v = queue.extractMin();
+		if (isStalled(v, forward, context))
+			continue;
+		settled.push_back(v);
+		relaxUp(v, forward, context, queue);
+	}
+}
+
+/*** Many-to-many ***/
+
+vector<double> ContractionHierarchy::distanceTable(const vector<unsigned>& sources, const vector<unsigned>& targets) const {
+	vector<double> table(sources.size() * targets.size(), INF);
+	SearchContext context;
+	vector<unsigned> settled;
+
+	// Buckets: each vertex reached down to a target keeps (target, distance), grouped by vertex
+	struct Entry {
+		unsigned target;
+		double dist;
+	};
+	vector<pair<unsigned, Entry>> entries;
+	for (unsigned t = 0; t < targets.size(); t++) {
+		upwardSearch(targets[t], false, context, settled);
+		for (unsigned v : settled)
+			entries.push_back({ v, { t, context.dist[v] } });
+	}
+	vector<unsigned> bucketOffsets(rank.size() + 1, 0);
+	for (const pair<unsigned, Entry>& entry : entries)
+		bucketOffsets[entry.first + 1]++;
+	for (size_t v = 0; v < rank.size(); v++)
+		bucketOffsets[v + 1] += bucketOffsets[v];
+	vector<Entry> buckets(entries.size());
+	vector<unsigned> next(bucketOffsets.begin(), bucketOffsets.end() - 1);
+	for (const pair<unsigned, Entry>& entry : entries)
+		buckets[next[entry.first]++] = entry.second;
+
+	for (size_t s = 0; s < sources.size(); s++) {
+		double* row = &table[s * targets.size()];
+		upwardSearch(sources[s], true, context, settled);
+		for (unsigned v : settled) {
+			double dist = context.dist[v];
+			for (unsigned b = bucketOffsets[v]; b < bucketOffsets[v + 1]; b++)
+				row[buckets[b].target] = min(row[buckets[b].target], dist + buckets[b].dist);
+		}
+	}
+	return table;
+}
+
+PathMatrix ContractionHierarchy::getPathMatrix(shared_ptr<const ContractionHierarchy> hierarchy, const vector<int>& ids) {
+	const Graph& graph = *hierarchy->graph;
+	vector<unsigned> indexes;
+	vector<int> knownIDs;
+	for (int id : ids) {
+		Vertex* v = graph.findVertex(id);
+		if (v != NULL) {
+			indexes.push_back(v->getIndex());
+			knownIDs.push_back(id);
+		}
+	}
+	vector<double> table = hierarchy->distanceTable(indexes, indexes);
+
+	PathMatrix matrix;
+	for (size_t i = 0; i < knownIDs.size(); i++) {
+		for (size_t j = 0; j < knownIDs.size(); j++)
+			matrix.setDist(knownIDs[i], knownIDs[j], table[i * knownIDs.size() + j]);
+	}
+	// The search state is part of the path source, so every copy of the matrix (and of its source) has its own
+	matrix.setPathSource([hierarchy, context = BidirectionalContext()](int srcID, int destID) mutable {
+		hierarchy->query(srcID, destID, context);
+		return hierarchy->getPath(context);
+	});
+	return matrix;
+}
+
+// The arc between from and to (one of them is the higher ranked end), NULL if there's none
+const ContractionHierarchy::Arc* ContractionHierarchy::findArc(unsigned from, unsigned to) const {
+	if (rank[from] < rank[to]) {
+		for (unsigned a = forwardOffsets[from]; a < forwardOffsets[from + 1]; a++) {
+			if (forwardArcs[a].vertex == to)
+				return &forwardArcs[a];
+		}
+	}
+	else {
+		for (unsigned a = backwardOffsets[to]; a < backwardOffsets[to + 1]; a++) {
+			if (backwardArcs[a].vertex == from)
+				return &backwardArcs[a];
+		}
+	}
+	return NULL;
+}
+
+// Appends the vertices of the arc from -> to after from, replacing each shortcut by the two arcs it was made of
+void ContractionHierarchy::unpack(unsigned from, unsigned to, vector<Vertex*>& path) const {
+	const Arc* arc = findArc(from, to);
+	if (arc == NULL || arc->middle < 0 || rank[arc->middle] >= min(rank[from], rank[to])) {	// (the last two only in a corrupt file)
+		path.push_back(graph->getVertexSet()[to]);
+		return;
+	}
+	unsigned middle = (unsigned)arc->middle;
+	unpack(from, middle, path);
+	unpack(middle, to, path);
+}
+
+vector<Vertex*> ContractionHierarchy::getPath(const BidirectionalContext& context) const {
+	vector<Vertex*> res;
+	if (context.meeting < 0)
+		return res;
+	vector<unsigned> up;	// the vertices of the path in the hierarchy, from the source
+	for (int v = context.meeting; v != -1; v = context.forward.path[v])
+		up.push_back(v);
+	reverse(up.begin(), up.end());
+	for (int v = context.backward.path[context.meeting]; v != -1; v = context.backward.path[v])
+		up.push_back(v);
+
+	res.push_back(graph->getVertexSet()[up[0]]);
+	for (size_t i = 1; i < up.size(); i++)
+		unpack(up[i - 1], up[i], res);
+	return res;
+}
+
+/*** Serialization ***/
+
+bool ContractionHierarchy::save(const string& path) const {
+	string tmpPath = path + ".tmp";
+	{
+		ofstream out(tmpPath, ios::binary | ios::trunc);
+		if (!out)
+			return false;
+		unsigned long long counts[] = { rank.size(), forwardArcs.size(), backwardArcs.size(), numShortcuts };
+		out.write(MAGIC, sizeof(MAGIC));
+		out.write((const char*)counts, sizeof(counts));
+		out.write((const char*)rank.data(), rank.size() * sizeof(unsigned));
+		out.write((const char*)forwardOffsets.data(), forwardOffsets.size() * sizeof(unsigned));
+		out.write((const char*)forwardArcs.data(), forwardArcs.size() * sizeof(Arc));
+		out.write((const char*)backwardOffsets.data(), backwardOffsets.size() * sizeof(unsigned));
+		out.write((const char*)backwardArcs.data(), backwardArcs.size() * sizeof(Arc));
+		if (!out.flush()) {
+			out.close();
+			remove(tmpPath.c_str());
+			return false;
+		}
+	}
+	remove(path.c_str());
+	return rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+// Whether offsets are a valid CSR index of numArcs arcs whose vertices are all below numVertices
+static bool validCSR(const vector<unsigned>& offsets, const vector<ContractionHierarchy::Arc>& arcs, size_t numVertices) {
+	if (offsets[0] != 0 || offsets.back() != arcs.size())
+		return false;
+	for (size_t v = 0; v + 1 < offsets.size(); v++) {
+		if (offsets[v] > offsets[v + 1])
+			return false;
+	}
+	for (const ContractionHierarchy::Arc& arc : arcs) {
+		if (arc.vertex >= numVertices || arc.middle >= (int)numVertices || arc.middle < -1)
+			return false;
+	}
+	return true;
+}
+
+bool ContractionHierarchy::load(const string& path) {
+	rank.clear();
+	forwardOffsets.clear();
+	backwardOffsets.clear();
+	forwardArcs.clear();
+	backwardArcs.clear();
+	numShortcuts = 0;
+	MappedFile file(path);
+	if (!file.isOpen() || file.size() < sizeof(MAGIC) || memcmp(file.begin(), MAGIC, sizeof(MAGIC)) != 0)
+		return false;
+
+	const char* p = file.begin() + sizeof(MAGIC);
+	auto read = [&](void* value, size_t size) {
+		if ((size_t)(file.end() - p) < size)
+			return false;
+		memcpy(value, p, size);
+		p += size;
+		return true;
+	};
+	unsigned long long counts[4];
+	if (!read(counts, sizeof(counts)) || counts[0] != graph->getNumVertex())
+		return false;
+	size_t numVertices = (size_t)counts[0];
+	size_t remainingBytes = (size_t)(file.end() - p);
+	if (counts[1] > remainingBytes / sizeof(Arc) || counts[2] > remainingBytes / sizeof(Arc))
+		return false;
+	rank.resize(numVertices);
+	forwardOffsets.resize(numVertices + 1);
+	forwardArcs.resize((size_t)counts[1]);
+	backwardOffsets.resize(numVertices + 1);
+	backwardArcs.resize((size_t)counts[2]);
+	bool valid = read(rank.data(), rank.size() * sizeof(unsigned))
+		&& read(forwardOffsets.data(), forwardOffsets.size() * sizeof(unsigned))
+		&& read(forwardArcs.data(), forwardArcs.size() * sizeof(Arc))
+		&& read(backwardOffsets.data(), backwardOffsets.size() * sizeof(unsigned))
+		&& read(backwardArcs.data(), backwardArcs.size() * sizeof(Arc))
+		&& p == file.end()
+		&& validCSR(forwardOffsets, forwardArcs, numVertices) && validCSR(backwardOffsets, backwardArcs, numVertices);
+	for (size_t v = 0; valid && v < numVertices; v++)
+		valid = rank[v] < numVertices;
+	if (!valid) {
+		rank.clear();
+		forwardOffsets.clear();
+		backwardOffsets.clear();
+		forwardArcs.clear();
+		backwardArcs.clear();
+		return false;
+	}
+	numShortcuts = (size_t)counts[3];
+	return true;
+}
+
+size_t ContractionHierarchy::getMemoryUsage() const {
+	return sizeof(ContractionHierarchy) + rank.capacity() * sizeof(unsigned)
+		+ (forwardOffsets.capacity() + backwardOffsets.capacity()) * sizeof(unsigned)
+		+ (forwardArcs.capacity() + backwardArcs.capacity()) * sizeof(Arc);
+}
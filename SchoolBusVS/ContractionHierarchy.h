@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "Graph.h"
+
+using namespace std;
+
+/**
+ * Contraction Hierarchies of a graph, for exact point-to-point queries that settle a few hundred vertices.
+ * The vertices are contracted in order of importance (edge difference + deleted neighbours). Contracting a
+ * vertex adds a shortcut between each pair of its neighbours whose shortest path went through it, unless a
+ * witness search finds another path as short. A query is a bidirectional Dijkstra that only goes up the
+ * hierarchy, and the shortcuts of its path are unpacked back to the edges of the graph.
+ *
+ * The hierarchy refers to the dense indexes of the graph it's made for, so it must not outlive it.
+ */
+class ContractionHierarchy {
+public:
+	// Edge of the hierarchy between a vertex and a higher ranked one
+	struct Arc {
+		double weight;
+		unsigned vertex;	// the higher ranked end
+		int middle;			// vertex contracted to make this shortcut, -1 for an edge of the graph
+	};
+private:
+	const Graph* graph;
+	vector<unsigned> rank;	// dense index -> position in the contraction order
+	// Arcs of each vertex, in CSR form: the outgoing ones to higher ranked vertices (searched from the source)
+	// and the incoming ones from higher ranked vertices (searched from the target)
+	vector<unsigned> forwardOffsets, backwardOffsets;
+	vector<Arc> forwardArcs, backwardArcs;
+	size_t numShortcuts = 0;
+
+	bool isStalled(unsigned v, bool forward, const SearchContext& context) const;
+	void relaxUp(unsigned v, bool forward, SearchContext& context, IndexedPriorityQueue<double>& queue) const;
+	const Arc* findArc(unsigned from, unsigned to) const;
+	void unpack(unsigned from, unsigned to, vector<Vertex*>& path) const;
+public:
+	/**
+	 * Empty hierarchy of graph, to be built or loaded. The graph must be finalized.
+	 */
+	ContractionHierarchy(const Graph& graph) : graph(&graph) {}
+
+	/**
+	 * Contracts every vertex of the graph. The witness searches and the priorities of each round of independent
+	 * vertices run on numThreads threads; the result is the same for any number of threads.
+	 */
+	void build(unsigned numThreads = 1);
+	bool isBuilt() const { return rank.size() == graph->getNumVertex() && !forwardOffsets.empty(); }
+
+	size_t getNumShortcuts() const { return numShortcuts; }
+	size_t getNumArcs() const { return forwardArcs.size() + backwardArcs.size(); }
+	unsigned getRank(unsigned vertex) const { return rank[vertex]; }
+	const vector<unsigned>& getForwardOffsets() const { return forwardOffsets; }
+	const vector<Arc>& getForwardArcs() const { return forwardArcs; }
+	const vector<unsigned>& getBackwardOffsets() const { return backwardOffsets; }
+	const vector<Arc>& getBackwardArcs() const { return backwardArcs; }
+
+	/**
+	 * Distance from sourceID to targetID (INF if there's no path). The upward searches are kept in context,
+	 * from which getPath unpacks the path.
+	 */
+	double query(int sourceID, int targetID, BidirectionalContext& context) const;
+	vector<Vertex*> getPath(const BidirectionalContext& context) const;
+
+	/**
+	 * Upward search from start (downward to it when !forward), leaving the distances in context. settled gets the
+	 * vertices that aren't stalled, whose distances are exact within the hierarchy: the only ones a shortest path
+	 * can turn down from.
+	 */
+	void upwardSearch(unsigned start, bool forward, SearchContext& context, vector<unsigned>& settled) const;
+
+	/**
+	 * Distances from every source to every target (dense indexes), row by row, INF where there's no path.
+	 * Each target leaves the distances of its backward upward search in buckets at the vertices it reaches,
+	 * which the forward upward search of each source then scans: one small search per source and per target.
+	 */
+	vector<double> distanceTable(const vector<unsigned>& sources, const vector<unsigned>& targets) const;
+
+	/**
+	 * Distances between every pair of ids, as a PathMatrix whose paths are only unpacked (by a query on the hierarchy)
+	 * when they're first asked for. The matrix keeps the hierarchy alive. IDs that aren't in the graph are left out.
+	 */
+	static PathMatrix getPathMatrix(shared_ptr<const ContractionHierarchy> hierarchy, const vector<int>& ids);
+
+	/**
+	 * Writes the hierarchy to a binary file, replacing it only once complete. Returns false if it couldn't be written.
+	 */
+	bool save(const string& path) const;
+
+	/**
+	 * Replaces the hierarchy with the one saved at path. Returns false (leaving it empty) if the file is missing
+	 * or malformed, or was made for a graph with another number of vertices.
+	 */
+	bool load(const string& path);
+
+	size_t getMemoryUsage() const;	// approximate heap usage, in bytes
+};
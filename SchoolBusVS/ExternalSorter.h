@@ -0,0 +1,162 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <queue>
+#include <memory>
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+/**
+ * Sorts more records than fit in memory. Records are buffered up to a byte budget; every full buffer is sorted
+ * and written to a temporary run file (pathPrefix.N), and a Reader streams them back in order with a k-way merge.
+ * Less must be a strict total order, since runs are not merged stably. Record must be trivially copyable.
+ */
+template <class Record, class Less>
+class ExternalSorter {
+	string pathPrefix;
+	size_t memoryBudget;
+	Less less;
+	vector<Record> buffer;
+	vector<string> runs;
+	size_t count = 0;
+	bool sorted = false;
+
+	void writeRun();
+public:
+	class Reader;
+
+	ExternalSorter(const string& pathPrefix, size_t memoryBudget, Less less = Less());
+	~ExternalSorter();
+	ExternalSorter(const ExternalSorter&) = delete;
+	ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+	void add(const Record& record);
+	size_t size() const { return count; }
+
+	/**
+	 * Reads every record added so far in order. Once read() is called no more records can be added,
+	 * but the records can be read again.
+	 */
+	Reader read();
+};
+
+template <class Record, class Less>
+class ExternalSorter<Record, Less>::Reader {
+	struct Run {
+		ifstream file;
+		vector<Record> block;
+		size_t blockSize;
+		size_t next = 0;
+		bool fill() {
+			block.resize(blockSize);
+			file.read((char*)block.data(), block.size() * sizeof(Record));
+			block.resize((size_t)file.gcount() / sizeof(Record));
+			next = 0;
+			return !block.empty();
+		}
+	};
+	const ExternalSorter* sorter;
+	size_t position = 0;	// in sorter->buffer, when nothing was written to disk
+	vector<unique_ptr<Run>> runs;
+	// (record, run) with the smallest record on top
+	struct Greater {
+		const Less* less;
+		bool operator()(const pair<Record, size_t>& a, const pair<Record, size_t>& b) const { return (*less)(b.first, a.first); }
+	};
+	priority_queue<pair<Record, size_t>, vector<pair<Record, size_t>>, Greater> heap;
+public:
+	Reader(const ExternalSorter* sorter);
+
+	/**
+	 * Stores the next record in record, returns false once every record was read.
+	 */
+	bool next(Record& record);
+};
+
+template <class Record, class Less>
+ExternalSorter<Record, Less>::ExternalSorter(const string& pathPrefix, size_t memoryBudget, Less less)
+	: pathPrefix(pathPrefix), memoryBudget(max(memoryBudget, sizeof(Record))), less(less) {
+}
+
+template <class Record, class Less>
+ExternalSorter<Record, Less>::~ExternalSorter() {
+	for (const string& run : runs)
+		remove(run.c_str());
+}
+
+template <class Record, class Less>
+void ExternalSorter<Record, Less>::writeRun() {
+	sort(buffer.begin(), buffer.end(), less);
+	string path = pathPrefix + "." + to_string(runs.size());
+	ofstream file(path, ios::binary | ios::trunc);
+	file.write((const char*)buffer.data(), buffer.size() * sizeof(Record));
+	if (!file.flush())
+		throw ios_base::failure("Couldn't write sort run " + path);
+	runs.push_back(path);
+	buffer.clear();
+}
+
+template <class Record, class Less>
+void ExternalSorter<Record, Less>::add(const Record& record) {
+	if (buffer.size() == buffer.capacity()) {
+		// Grows up to the budget (counting the old buffer while it's copied), then spills to a run
+		size_t limit = max<size_t>(memoryBudget * 2 / 3 / sizeof(Record), 1);
+		if (buffer.capacity() < limit)
+			buffer.reserve(min(max<size_t>(2 * buffer.capacity(), 1024), limit));
+		else writeRun();
+	}
+	buffer.push_back(record);
+	count++;
+}
+
+template <class Record, class Less>
+typename ExternalSorter<Record, Less>::Reader ExternalSorter<Record, Less>::read() {
+	if (!sorted) {
+		if (runs.empty())
+			sort(buffer.begin(), buffer.end(), less);
+		else if (!buffer.empty())
+			writeRun();
+		buffer.shrink_to_fit();
+		sorted = true;
+	}
+	return Reader(this);
+}
+
+template <class Record, class Less>
+ExternalSorter<Record, Less>::Reader::Reader(const ExternalSorter* sorter) : sorter(sorter), heap(Greater{ &sorter->less }) {
+	if (sorter->runs.empty())
+		return;
+	// The read blocks of all the runs share the memory budget
+	size_t blockSize = max<size_t>(sorter->memoryBudget / sizeof(Record) / sorter->runs.size(), 1);
+	for (size_t i = 0; i < sorter->runs.size(); i++) {
+		unique_ptr<Run> run(new Run);
+		run->file.open(sorter->runs[i], ios::binary);
+		run->blockSize = blockSize;
+		if (run->fill())
+			heap.push(make_pair(run->block[run->next++], i));
+		runs.push_back(move(run));
+	}
+}
+
+template <class Record, class Less>
+bool ExternalSorter<Record, Less>::Reader::next(Record& record) {
+	if (sorter->runs.empty()) {
+		if (position == sorter->buffer.size())
+			return false;
+		record = sorter->buffer[position++];
+		return true;
+	}
+	if (heap.empty())
+		return false;
+	record = heap.top().first;
+	size_t i = heap.top().second;
+	heap.pop();
+	Run& run = *runs[i];
+	if (run.next < run.block.size() || run.fill())
+		heap.push(make_pair(run.block[run.next++], i));
+	return true;
+}
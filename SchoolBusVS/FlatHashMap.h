@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * Open addressing (linear probing) hash map for integer keys.
+ * All entries live in three flat arrays, so filling it costs a few allocations instead of one per entry.
+ * Entries can't be erased.
+ */
+template <class Key, class Value>
+class FlatHashMap {
+	vector<Key> keys;
+	vector<Value> values;
+	vector<char> used;
+	size_t count = 0;
+	size_t mask = 0;
+
+	static size_t hash(Key key) {
+		unsigned long long h = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+		return (size_t)(h ^ (h >> 32));
+	}
+	size_t slotOf(Key key) const;
+	void rehash(size_t capacity);
+public:
+	const Value* find(Key key) const;
+	Value* find(Key key);
+	Value& operator[](Key key);	// inserts a default constructed value if the key doesn't exist
+	void reserve(size_t n);
+	void clear();
+	size_t size() const { return count; }
+	size_t memoryUsage() const { return keys.capacity() * sizeof(Key) + values.capacity() * sizeof(Value) + used.capacity(); }
+};
+
+template <class Key, class Value>
+size_t FlatHashMap<Key, Value>::slotOf(Key key) const {
+	size_t i = hash(key) & mask;
+	while (used[i] && keys[i] != key)
+		i = (i + 1) & mask;
+	return i;
+}
+
+template <class Key, class Value>
+void FlatHashMap<Key, Value>::rehash(size_t capacity) {
+	vector<Key> oldKeys;
+	vector<Value> oldValues;
+	vector<char> oldUsed;
+	oldKeys.swap(keys);
+	oldValues.swap(values);
+	oldUsed.swap(used);
+
+	keys.resize(capacity);
+	values.resize(capacity);
+	used.assign(capacity, false);
+	mask = capacity - 1;
+
+	for (size_t i = 0; i < oldUsed.size(); i++) {
+		if (!oldUsed[i])
+			continue;
+		size_t slot = slotOf(oldKeys[i]);
+		used[slot] = true;
+		keys[slot] = oldKeys[i];
+		values[slot] = std::move(oldValues[i]);
+	}
+}
+
+template <class Key, class Value>
+const Value* FlatHashMap<Key, Value>::find(Key key) const {
+	if (count == 0)
+		return NULL;
+	size_t slot = slotOf(key);
+	return used[slot] ? &values[slot] : NULL;
+}
+
+template <class Key, class Value>
+Value* FlatHashMap<Key, Value>::find(Key key) {
+	if (count == 0)
+		return NULL;
+	size_t slot = slotOf(key);
+	return used[slot] ? &values[slot] : NULL;
+}
+
+template <class Key, class Value>
+Value& FlatHashMap<Key, Value>::operator[](Key key) {
+	if ((count + 1) * 2 > used.size())
+		rehash(used.empty() ? 16 : used.size() * 2);
+	size_t slot = slotOf(key);
+	if (!used[slot]) {
+		used[slot] = true;
+		keys[slot] = key;
+		values[slot] = Value();
+		count++;
+	}
+	return values[slot];
+}
+
+template <class Key, class Value>
+void FlatHashMap<Key, Value>::reserve(size_t n) {
+	size_t capacity = 16;
+	while (capacity < n * 2)
+		capacity *= 2;
+	if (capacity > used.size())
+		rehash(capacity);
+}
+
+template <class Key, class Value>
+void FlatHashMap<Key, Value>::clear() {
+	keys.clear();
+	values.clear();
+	used.clear();
+	count = 0;
+	mask = 0;
+}
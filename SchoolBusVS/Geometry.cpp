@@ -0,0 +1,105 @@
+#include "Geometry.h"
+#include <cmath>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GEOMETRY_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GEOMETRY_SSE2
+#endif
+
+void geometry::edgeLengths(const double* xs, const double* ys, const unsigned* src, const unsigned* dest, double* out, size_t n) {
+	size_t i = 0;
+#if defined(GEOMETRY_AVX2)
+	for (; i + 4 <= n; i += 4) {
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+		__m256d dx = _mm256_sub_pd(_mm256_i32gather_pd(xs, d, 8), _mm256_i32gather_pd(xs, s, 8));
+		__m256d dy = _mm256_sub_pd(_mm256_i32gather_pd(ys, d, 8), _mm256_i32gather_pd(ys, s, 8));
+		__m256d sq = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+		_mm256_storeu_pd(out + i, _mm256_sqrt_pd(sq));
+	}
+#elif defined(GEOMETRY_SSE2)
+	for (; i + 2 <= n; i += 2) {
+		__m128d dx = _mm_sub_pd(_mm_set_pd(xs[dest[i + 1]], xs[dest[i]]), _mm_set_pd(xs[src[i + 1]], xs[src[i]]));
+		__m128d dy = _mm_sub_pd(_mm_set_pd(ys[dest[i + 1]], ys[dest[i]]), _mm_set_pd(ys[src[i + 1]], ys[src[i]]));
+		__m128d sq = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+		_mm_storeu_pd(out + i, _mm_sqrt_pd(sq));
+	}
+#endif
+	for (; i < n; i++) {
+		double dx = xs[dest[i]] - xs[src[i]];
+		double dy = ys[dest[i]] - ys[src[i]];
+		out[i] = sqrt(dx * dx + dy * dy);
+	}
+}
+
+void geometry::segmentLengths(const double* xs, const double* ys, size_t numPoints, double* out) {
+	if (numPoints < 2)
+		return;
+	size_t n = numPoints - 1;
+	size_t i = 0;
+#if defined(GEOMETRY_AVX2)
+	for (; i + 4 <= n; i += 4) {
+		__m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i + 1), _mm256_loadu_pd(xs + i));
+		__m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i + 1), _mm256_loadu_pd(ys + i));
+		__m256d sq = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+		_mm256_storeu_pd(out + i, _mm256_sqrt_pd(sq));
+	}
+#elif defined(GEOMETRY_SSE2)
+	for (; i + 2 <= n; i += 2) {
+		__m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i + 1), _mm_loadu_pd(xs + i));
+		__m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i + 1), _mm_loadu_pd(ys + i));
+		__m128d sq = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+		_mm_storeu_pd(out + i, _mm_sqrt_pd(sq));
+	}
+#endif
+	for (; i < n; i++) {
+		double dx = xs[i + 1] - xs[i];
+		double dy = ys[i + 1] - ys[i];
+		out[i] = sqrt(dx * dx + dy * dy);
+	}
+}
+
+void geometry::geodesicLengths(const double* lats, const double* lons, size_t numVertices,
+	const unsigned* src, const unsigned* dest, double* out, size_t n) {
+	// Per vertex: position on the sphere in metres along the meridian (ys) and the equator (xs),
+	// and the factor that shrinks the parallels at its latitude
+	const double toRadians = 3.14159265358979323846 / 180;
+	std::vector<double> xs(numVertices), ys(numVertices), cosLats(numVertices);
+	for (size_t v = 0; v < numVertices; v++) {
+		xs[v] = EARTH_RADIUS * lons[v] * toRadians;
+		ys[v] = EARTH_RADIUS * lats[v] * toRadians;
+		cosLats[v] = cos(lats[v] * toRadians);
+	}
+
+	size_t i = 0;
+#if defined(GEOMETRY_AVX2)
+	const __m256d half = _mm256_set1_pd(0.5);
+	for (; i + 4 <= n; i += 4) {
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+		__m256d scale = _mm256_mul_pd(half, _mm256_add_pd(_mm256_i32gather_pd(cosLats.data(), s, 8), _mm256_i32gather_pd(cosLats.data(), d, 8)));
+		__m256d dx = _mm256_mul_pd(scale, _mm256_sub_pd(_mm256_i32gather_pd(xs.data(), d, 8), _mm256_i32gather_pd(xs.data(), s, 8)));
+		__m256d dy = _mm256_sub_pd(_mm256_i32gather_pd(ys.data(), d, 8), _mm256_i32gather_pd(ys.data(), s, 8));
+		__m256d sq = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+		_mm256_storeu_pd(out + i, _mm256_sqrt_pd(sq));
+	}
+#elif defined(GEOMETRY_SSE2)
+	const __m128d half = _mm_set1_pd(0.5);
+	for (; i + 2 <= n; i += 2) {
+		__m128d scale = _mm_mul_pd(half, _mm_add_pd(_mm_set_pd(cosLats[src[i + 1]], cosLats[src[i]]), _mm_set_pd(cosLats[dest[i + 1]], cosLats[dest[i]])));
+		__m128d dx = _mm_mul_pd(scale, _mm_sub_pd(_mm_set_pd(xs[dest[i + 1]], xs[dest[i]]), _mm_set_pd(xs[src[i + 1]], xs[src[i]])));
+		__m128d dy = _mm_sub_pd(_mm_set_pd(ys[dest[i + 1]], ys[dest[i]]), _mm_set_pd(ys[src[i + 1]], ys[src[i]]));
+		__m128d sq = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+		_mm_storeu_pd(out + i, _mm_sqrt_pd(sq));
+	}
+#endif
+	for (; i < n; i++) {
+		double dx = 0.5 * (cosLats[src[i]] + cosLats[dest[i]]) * (xs[dest[i]] - xs[src[i]]);
+		double dy = ys[dest[i]] - ys[src[i]];
+		out[i] = sqrt(dx * dx + dy * dy);
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Batch distance kernels over coordinate arrays (structure of arrays).
+ * Uses AVX2 or SSE2 when the compiler targets them and plain scalar code otherwise.
+ */
+namespace geometry {
+	/**
+	 * Euclidean length of n segments given by vertex indexes into the coordinate arrays.
+	 *
+	 * @param xs X coordinates, indexed by vertex
+	 * @param ys Y coordinates, indexed by vertex
+	 * @param src First endpoint of each segment
+	 * @param dest Second endpoint of each segment
+	 * @param out Receives the n lengths
+	 * @param n Number of segments
+	 */
+	void edgeLengths(const double* xs, const double* ys, const unsigned* src, const unsigned* dest, double* out, size_t n);
+
+	/**
+	 * Lengths of the segments of a polyline: out[i] is the distance from point i to point i + 1.
+	 *
+	 * @param xs X coordinates of the points
+	 * @param ys Y coordinates of the points
+	 * @param numPoints Number of points (out receives numPoints - 1 lengths)
+	 * @param out Receives the lengths
+	 */
+	void segmentLengths(const double* xs, const double* ys, size_t numPoints, double* out);
+
+	// Mean radius of the Earth, in metres
+	const double EARTH_RADIUS = 6371008.8;
+
+	/**
+	 * Length in metres of n segments given by vertex indexes into latitude/longitude arrays (in degrees).
+	 * The trigonometry is done once per vertex; each segment is then measured on an equirectangular projection
+	 * at its mean latitude, which for road segments (up to a few km) is within 1e-6 of the haversine distance.
+	 *
+	 * @param lats Latitudes, indexed by vertex
+	 * @param lons Longitudes, indexed by vertex
+	 * @param numVertices Number of vertices (size of lats and lons)
+	 * @param src First endpoint of each segment
+	 * @param dest Second endpoint of each segment
+	 * @param out Receives the n lengths
+	 * @param n Number of segments
+	 */
+	void geodesicLengths(const double* lats, const double* lons, size_t numVertices,
+		const unsigned* src, const unsigned* dest, double* out, size_t n);
+}
@@ -1,4 +1,5 @@
 #include "Graph.h"
+#include "SearchAlgorithms.h"
 
 // -- Edge -- //
 
@@ -20,12 +21,12 @@ double Edge::getWeight() {
 
 // -- Vertex -- //
 
-void Vertex::addEdge(int ID, Vertex *d, double w) {
-	for (Edge* e : adj) {		
-		if (e->dest == d)
-			return;
-	}
-	adj.push_back(new Edge(ID, d, w));
+void Vertex::addEdge(Edge* edge) {
+	if (lastEdge == NULL)
+		firstEdge = edge;
+	else lastEdge->next = edge;
+	lastEdge = edge;
+	outDegree++;
 }
 
 inline Vertex::Vertex(int ID, double x, double y) {
@@ -34,8 +35,8 @@ inline Vertex::Vertex(int ID, double x, double y) {
 	this->y = y;
 }
 
-bool Vertex::operator<(Vertex & vertex) const {
-	return this->dist < vertex.dist;
+unsigned Vertex::getIndex() const {
+	return this->index;
 }
 
 int Vertex::getID() const {
@@ -50,50 +51,202 @@ double Vertex::getY() const {
 	return this->y;
 }
 
-double Vertex::getDist() const {
-	return this->dist;
+EdgeList Vertex::getAdj() const {
+	return EdgeList(firstEdge, outDegree);
 }
 
-vector<Edge*> Vertex::getAdj() const {
-	return adj;
-}
+// -- Graph -- //
 
-Vertex *Vertex::getPath() const {
-	return this->path;
+static unsigned long long edgeKey(unsigned srcIndex, unsigned destIndex) {
+	return ((unsigned long long)srcIndex << 32) | destIndex;
 }
 
-// -- Graph -- //
+void Graph::reserve(size_t numVertices, size_t numEdges) {
+	vertexSet.reserve(numVertices);
+	xs.reserve(numVertices);
+	ys.reserve(numVertices);
+	vertexPool.reserve(numVertices);
+	idToIndex.reserve(numVertices);
+	edgePool.reserve(numEdges);
+	edgeIndex.reserve(numEdges);
+	edgesByID.reserve(numEdges);
+}
 
 size_t Graph::getNumVertex() const {
 	return vertexSet.size();
 }
 
-vector<Vertex *> Graph::getVertexSet() const {
+const vector<Vertex *>& Graph::getVertexSet() const {
 	return vertexSet;
 }
 
-Vertex * Graph::findVertex(int ID) const {
-	for (auto v : vertexSet) {
-		if (v->ID == ID)
-			return v;
+const vector<double>& Graph::getXs() const {
+	return xs;
+}
+
+const vector<double>& Graph::getYs() const {
+	return ys;
+}
+
+void Graph::setGeoCoordinates(vector<int> latsE7, vector<int> lonsE7) {
+	this->latsE7 = move(latsE7);
+	this->lonsE7 = move(lonsE7);
+}
+
+bool Graph::hasGeoCoordinates() const {
+	return !latsE7.empty() && latsE7.size() == vertexSet.size();
+}
+
+const vector<int>& Graph::getLatsE7() const {
+	return latsE7;
+}
+
+const vector<int>& Graph::getLonsE7() const {
+	return lonsE7;
+}
+
+double Graph::getLat(unsigned index) const {
+	return latsE7[index] * 1e-7;
+}
+
+double Graph::getLon(unsigned index) const {
+	return lonsE7[index] * 1e-7;
+}
+
+const vector<unsigned>& Graph::getCSROffsets() const {
+	return csrOffsets;
+}
+
+const vector<unsigned>& Graph::getCSRTargets() const {
+	return csrTargets;
+}
+
+const vector<double>& Graph::getCSRWeights() const {
+	return csrWeights;
+}
+
+const vector<int>& Graph::getCSREdgeIDs() const {
+	return csrEdgeIDs;
+}
+
+size_t Graph::getNumEdges() const {
+	return edgePool.size();
+}
+
+template <class T>
+static size_t vectorBytes(const vector<T>& v) {
+	return v.capacity() * sizeof(T);
+}
+
+size_t Graph::getMemoryUsage() const {
+	return sizeof(Graph) + vectorBytes(vertexSet) + vectorBytes(xs) + vectorBytes(ys) + vectorBytes(latsE7) + vectorBytes(lonsE7)
+		+ vertexPool.memoryUsage() + edgePool.memoryUsage()
+		+ idToIndex.memoryUsage() + vectorBytes(edgesByID) + edgeIndex.memoryUsage()
+		+ vectorBytes(csrOffsets) + vectorBytes(csrTargets) + vectorBytes(csrWeights) + vectorBytes(csrEdgeIDs)
+		+ vectorBytes(reverseOffsets) + vectorBytes(reverseSources) + vectorBytes(reverseWeights)
+		+ vectorBytes(searchContext.dist) + vectorBytes(searchContext.path) + vectorBytes(searchContext.visited) + vectorBytes(searchContext.queueIndex)
+		+ vectorBytes(searchContext.estimate);
+}
+
+/*** Builds the CSR arrays from the adjacency lists ***/
+
+void Graph::buildCSR() {
+	size_t numEdges = 0;
+	for (Vertex* v : vertexSet)
+		numEdges += v->outDegree;
+
+	csrOffsets.resize(vertexSet.size() + 1);
+	csrTargets.clear();
+	csrWeights.clear();
+	csrEdgeIDs.clear();
+	csrTargets.reserve(numEdges);
+	csrWeights.reserve(numEdges);
+	csrEdgeIDs.reserve(numEdges);
+
+	for (size_t i = 0; i < vertexSet.size(); i++) {
+		csrOffsets[i] = (unsigned)csrTargets.size();
+		for (Edge* e = vertexSet[i]->firstEdge; e != NULL; e = e->next) {
+			csrTargets.push_back(e->dest->index);
+			csrWeights.push_back(e->weight);
+			csrEdgeIDs.push_back(e->ID);
+		}
 	}
-	return NULL;
+	csrOffsets[vertexSet.size()] = (unsigned)csrTargets.size();
+	csrValid = true;
+	finishCSR();
 }
 
-Edge* Graph::findEdge(int ID) const {
-	for (Vertex* v : vertexSet) {
-		for (Edge* e : v->getAdj()) {
-			if (e->getID() == ID)
-				return e;
+void Graph::finalize() {
+	if (!csrValid)
+		buildCSR();
+}
+
+double Graph::getHeuristicScale() const {
+	return heuristicScale;
+}
+
+void Graph::finishCSR() {
+	size_t numVertices = vertexSet.size();
+	reverseOffsets.assign(numVertices + 1, 0);
+	for (unsigned target : csrTargets)
+		reverseOffsets[target + 1]++;
+	for (size_t v = 0; v < numVertices; v++)
+		reverseOffsets[v + 1] += reverseOffsets[v];
+	reverseSources.resize(csrTargets.size());
+	reverseWeights.resize(csrTargets.size());
+	vector<unsigned> next(reverseOffsets.begin(), reverseOffsets.end() - 1);
+	for (size_t v = 0; v < numVertices; v++) {
+		for (unsigned e = csrOffsets[v]; e < csrOffsets[v + 1]; e++) {
+			unsigned slot = next[csrTargets[e]]++;
+			reverseSources[slot] = (unsigned)v;
+			reverseWeights[slot] = csrWeights[e];
 		}
 	}
-	return NULL;
+
+	double scale = INF;
+	for (size_t v = 0; v < vertexSet.size(); v++) {
+		for (unsigned e = csrOffsets[v]; e < csrOffsets[v + 1]; e++) {
+			double dx = xs[v] - xs[csrTargets[e]], dy = ys[v] - ys[csrTargets[e]];
+			double length = sqrt(dx * dx + dy * dy);
+			if (length > 0)
+				scale = min(scale, csrWeights[e] / length);
+		}
+	}
+	heuristicScale = scale == INF ? 0 : max(scale, 0.0);
+}
+
+Vertex * Graph::findVertex(int ID) const {
+	const unsigned* index = idToIndex.find(ID);
+	if (index == NULL)
+		return NULL;
+	return vertexSet[*index];
+}
+
+Edge* Graph::findEdge(int ID) const {
+	if (ID < 0 || (size_t)ID >= edgesByID.size())
+		return NULL;
+	return edgesByID[ID];
+}
+
+Edge* Graph::findEdge(const Vertex* src, const Vertex* dest) const {
+	if (src == NULL || dest == NULL)
+		return NULL;
+	Edge* const* edge = edgeIndex.find(edgeKey(src->index, dest->index));
+	if (edge == NULL)
+		return NULL;
+	return *edge;
 }
 
 bool Graph::addVertex(int ID, double x, double y) {
 	if (findVertex(ID) != NULL)
 		return false;
-	vertexSet.push_back(new Vertex(ID, x, y));
+	Vertex* v = vertexPool.create(ID, x, y);
+	v->index = (unsigned)vertexSet.size();
+	idToIndex[ID] = v->index;
+	vertexSet.push_back(v);
+	xs.push_back(x);
+	ys.push_back(y);
+	csrValid = false;
 	return true;
 }
 
@@ -102,93 +255,150 @@ bool Graph::addEdge(int edgeID, int srcID, int destID, double w) {
 	Vertex* v2 = findVertex(destID);
 	if (v1 == NULL || v2 == NULL)
 		return false;
-	v1->addEdge(edgeID, v2, w);
+	Edge*& slot = edgeIndex[edgeKey(v1->index, v2->index)];
+	if (slot != NULL)
+		return true; // parallel edges are ignored
+	slot = edgePool.create(edgeID, v2, w);
+	v1->addEdge(slot);
+	if (edgeID >= 0) {
+		if ((size_t)edgeID >= edgesByID.size())
+			edgesByID.resize(edgeID + 1, NULL);
+		edgesByID[edgeID] = slot;
+	}
+	csrValid = false;
 	return true;
 }
 
+/*** Bulk construction ***/
 
-/*** Breadth First Search***/
+void Graph::addVertices(const vector<VertexRecord>& vertices) {
+	reserve(vertexSet.size() + vertices.size(), 0);
+	for (const VertexRecord& v : vertices)
+		addVertex(v.ID, v.x, v.y);
+}
 
-void Graph::BFS(Vertex* s)
-{
-	// Mark all the vertices as not visited 
-	for (auto v : vertexSet) {
-		v->visited = false; // known(v) in slides	
+void Graph::addEdges(const vector<EdgeRecord>& edges) {
+	size_t numVertices = vertexSet.size();
+	bool emptyGraph = edgePool.size() == 0;
+
+	// Bucket the edges by source vertex (counting sort, stable)
+	vector<unsigned> offsets(numVertices + 1, 0);
+	for (const EdgeRecord& e : edges)
+		offsets[e.srcIndex + 1]++;
+	for (size_t i = 0; i < numVertices; i++)
+		offsets[i + 1] += offsets[i];
+	vector<unsigned> order(edges.size());
+	vector<unsigned> next(offsets.begin(), offsets.end() - 1);
+	for (unsigned i = 0; i < edges.size(); i++)
+		order[next[edges[i].srcIndex]++] = i;
+
+	int maxID = -1;
+	for (const EdgeRecord& e : edges)
+		maxID = max(maxID, e.ID);
+	if ((size_t)(maxID + 1) > edgesByID.size())
+		edgesByID.resize(maxID + 1, NULL);
+	edgePool.reserve(edges.size());
+	edgeIndex.reserve(edgeIndex.size() + edges.size());
+
+	if (emptyGraph) {
+		csrOffsets.resize(numVertices + 1);
+		csrTargets.clear();
+		csrWeights.clear();
+		csrEdgeIDs.clear();
+		csrTargets.reserve(edges.size());
+		csrWeights.reserve(edges.size());
+		csrEdgeIDs.reserve(edges.size());
 	}
 
-	// Create a queue for BFS 
-	queue<Vertex*> q;
-
-	// Mark the current node as visited and enqueue it 
-	s->visited = true;
-	q.push(s);
-
-	// 'i' will be used to get all adjacent 
-	// vertices of a vertex 
-	list<int>::iterator i;
-
-	while (!q.empty())
-	{
-		// Dequeue a vertex from queue
-		s = q.front();
-		q.pop();
-
-		// Get all adjacent vertices of the dequeued 
-		// vertex s. If a adjacent has not been visited,  
-		// then mark it visited and enqueue it 
-		for(auto edge : s->adj)
-		{
-			
-			if (!(edge->dest->visited))
-			{
-				edge->dest->visited = true;
-				q.push(edge->dest);
+	// Sort every bucket by destination, so parallel edges become adjacent and only the first one added is kept
+	auto byDest = [&edges](unsigned a, unsigned b) {
+		return edges[a].destIndex < edges[b].destIndex || (edges[a].destIndex == edges[b].destIndex && a < b);
+	};
+	for (size_t v = 0; v < numVertices; v++) {
+		auto first = order.begin() + offsets[v], last = order.begin() + offsets[v + 1];
+		sort(first, last, byDest);
+		last = unique(first, last, [&edges](unsigned a, unsigned b) { return edges[a].destIndex == edges[b].destIndex; });
+
+		if (emptyGraph)
+			csrOffsets[v] = (unsigned)csrTargets.size();
+		for (auto it = first; it != last; it++) {
+			const EdgeRecord& e = edges[*it];
+			Edge*& slot = edgeIndex[edgeKey(e.srcIndex, e.destIndex)];
+			if (slot != NULL)
+				continue;
+			slot = edgePool.create(e.ID, vertexSet[e.destIndex], e.weight);
+			vertexSet[v]->addEdge(slot);
+			if (e.ID >= 0)
+				edgesByID[e.ID] = slot;
+			if (emptyGraph) {
+				csrTargets.push_back(e.destIndex);
+				csrWeights.push_back(e.weight);
+				csrEdgeIDs.push_back(e.ID);
 			}
 		}
 	}
+
+	if (emptyGraph) {
+		csrOffsets[numVertices] = (unsigned)csrTargets.size();
+		csrValid = true;
+		finishCSR();
+	}
+	else csrValid = false;
 }
 
-/*** Breadth First Search (ignores one vertex)***/
+/*** Builds an empty graph from arrays already in CSR form (e.g. a GraphSnapshot), without sorting them again ***/
+/*** Returns false, leaving the graph incomplete, if the IDs aren't unique ***/
 
-void Graph::BFS(Vertex* s, Vertex* removed)
-{
-	// Mark all the vertices as not visited 
-	for (auto v : vertexSet) {
-		v->visited = false; // known(v) in slides	
+bool Graph::addCSR(size_t numVertices, const int* ids, const double* xs, const double* ys,
+	const unsigned* offsets, const unsigned* targets, const double* weights, const int* edgeIDs) {
+	size_t numEdges = offsets[numVertices];
+	reserve(numVertices, numEdges);
+	for (size_t i = 0; i < numVertices; i++) {
+		if (!addVertex(ids[i], xs[i], ys[i]))
+			return false;	// the edges would refer to vertices that weren't added
 	}
 
-	// Create a queue for BFS 
-	queue<Vertex*> q;
-
-	// Mark the current node as visited and enqueue it 
-	s->visited = true;
-	q.push(s);
-
-	while (!q.empty())
-	{
-		// Dequeue a vertex from queue
-		s = q.front();
-		q.pop();
-
-		// Get all adjacent vertices of the dequeued 
-		// vertex s. If a adjacent has not been visited,  
-		// then mark it visited and enqueue it 
-		for (auto edge : s->adj)
-		{
-
-			if (!(edge->dest->visited) && edge->dest != removed) //!
-			{
-				edge->dest->visited = true;
-				q.push(edge->dest);
-			}
+	int maxID = -1;
+	for (size_t e = 0; e < numEdges; e++)
+		maxID = max(maxID, edgeIDs[e]);
+	edgesByID.resize(maxID + 1, NULL);
+	for (size_t v = 0; v < numVertices; v++) {
+		for (unsigned e = offsets[v]; e < offsets[v + 1]; e++) {
+			Edge* edge = edgePool.create(edgeIDs[e], vertexSet[targets[e]], weights[e]);
+			vertexSet[v]->addEdge(edge);
+			edgeIndex[edgeKey((unsigned)v, targets[e])] = edge;
+			if (edgeIDs[e] >= 0)
+				edgesByID[edgeIDs[e]] = edge;
 		}
 	}
+
+	csrOffsets.assign(offsets, offsets + numVertices + 1);
+	csrTargets.assign(targets, targets + numEdges);
+	csrWeights.assign(weights, weights + numEdges);
+	csrEdgeIDs.assign(edgeIDs, edgeIDs + numEdges);
+	csrValid = true;
+	finishCSR();
+	return true;
+}
+
+/*** Breadth First Search***/
+
+void Graph::BFS(Vertex* s, SearchContext& context) const
+{
+	search::bfs(*this, s->index, context);
+}
+
+/*** Breadth First Search (ignores one vertex)***/
+
+void Graph::BFS(Vertex* s, Vertex* removed, SearchContext& context) const
+{
+	search::bfs(*this, s->index, context, removed->index);
 }
 
 /*** Transpose Graph***/
 void Graph::transpose(Graph* transposed) {
 	for (Vertex* vertex : vertexSet)
-		for (auto edge : vertex->adj){
+		for (Edge* edge = vertex->firstEdge; edge != NULL; edge = edge->next) {
 			transposed->addVertex(vertex->ID, vertex->x, vertex->y);
 			transposed->addEdge(edge->ID, edge->dest->ID, vertex->ID, edge->weight);
 		}
@@ -196,13 +406,15 @@ void Graph::transpose(Graph* transposed) {
 
 /*** Shortest Path between POIs ***/
 
-PathMatrix* Graph::multipleDijkstra(const vector<int>& POIids) {
-	PathMatrix* matrix = new PathMatrix();
+PathMatrix Graph::multipleDijkstra(const vector<int>& POIids) {
+	finalize();
+	PathMatrix matrix;
+	SearchContext context;
 	for (int srcID : POIids) {
-		dijkstraShortestPath(srcID);
+		dijkstraShortestPath(srcID, context);
 		for (int destID : POIids) {
 			Vertex* dest = findVertex(destID);
-			matrix->setPath(srcID, destID, dest->dist, this->getPath(dest));
+			matrix.setPath(srcID, destID, context.dist[dest->index], this->getPath(dest, context));
 		}
 	}
 	return matrix;
@@ -210,106 +422,143 @@ PathMatrix* Graph::multipleDijkstra(const vector<int>& POIids) {
 /**************** Single Source Shortest Path algorithms ************/
 
 
-void Graph::dijkstraShortestPath(int sourceID) {
+void Graph::dijkstraShortestPath(int sourceID, SearchContext& context) const {
 	auto src = findVertex(sourceID);
 	if (src == NULL) {
+		context.reset(vertexSet.size());
 		cout << "Warning... Dijkstra shortest path from NULL." << endl;
 		return;
 	}
-	for (auto v : vertexSet) {
-		v->dist = INF;
-		v->path = NULL;
+	search::dijkstra<IndexedPriorityQueue<double>>(*this, src->index, context);
+}
+
+size_t Graph::aStarShortestPath(int sourceID, int targetID, SearchContext& context) const {
+	Vertex* src = findVertex(sourceID);
+	Vertex* target = findVertex(targetID);
+	if (src == NULL || target == NULL) {
+		context.reset(vertexSet.size());
+		cout << "Warning... A* shortest path from or to NULL." << endl;
+		return 0;
 	}
-	src->dist = 0;
-	MutablePriorityQueue<Vertex> queue;
-	queue.insert(src);
-	while (!queue.empty()) {
-		src = queue.extractMin();
-		for (auto edge : src->adj) {
-			if (edge->dest->dist > src->dist + edge->weight) {
-				double oldDist = edge->dest->dist;
-				edge->dest->dist = src->dist + edge->weight;
-				edge->dest->path = src;
-				if (oldDist == INF)
-					queue.insert(edge->dest);
-				else queue.decreaseKey(edge->dest);
-			}
-		}
+	double tx = xs[target->index], ty = ys[target->index], scale = heuristicScale;
+	auto heuristic = [&](unsigned v) {
+		double dx = xs[v] - tx, dy = ys[v] - ty;
+		return scale * sqrt(dx * dx + dy * dy);
+	};
+	return search::astar<IndexedPriorityQueue<double>>(*this, src->index, target->index, heuristic, context);
+}
+
+/*** Bidirectional searches ***/
+
+void Graph::bidirectionalDijkstra(int sourceID, int targetID, BidirectionalContext& context) const {
+	Vertex* src = findVertex(sourceID);
+	Vertex* target = findVertex(targetID);
+	if (src == NULL || target == NULL) {
+		context.forward.reset(vertexSet.size());
+		context.backward.reset(vertexSet.size());
+		context.meeting = -1;
+		context.dist = INF;
+		context.settled = 0;
+		cout << "Warning... Bidirectional shortest path from or to NULL." << endl;
+		return;
 	}
+	search::bidirectional<IndexedPriorityQueue<double>>(*this, ReversedAdjacency<Graph>(*this), src->index, target->index,
+		[](unsigned) { return 0.0; }, context);
 }
 
-vector<Vertex *> Graph::getPath(Vertex* dest) const {
+void Graph::bidirectionalAStar(int sourceID, int targetID, BidirectionalContext& context) const {
+	Vertex* src = findVertex(sourceID);
+	Vertex* target = findVertex(targetID);
+	if (src == NULL || target == NULL) {
+		context.forward.reset(vertexSet.size());
+		context.backward.reset(vertexSet.size());
+		context.meeting = -1;
+		context.dist = INF;
+		context.settled = 0;
+		cout << "Warning... Bidirectional shortest path from or to NULL." << endl;
+		return;
+	}
+	double sx = xs[src->index], sy = ys[src->index], tx = xs[target->index], ty = ys[target->index];
+	double halfScale = heuristicScale / 2;
+	auto potential = [&](unsigned v) {
+		double toTarget = sqrt((xs[v] - tx) * (xs[v] - tx) + (ys[v] - ty) * (ys[v] - ty));
+		double fromSource = sqrt((xs[v] - sx) * (xs[v] - sx) + (ys[v] - sy) * (ys[v] - sy));
+		return halfScale * (toTarget - fromSource);
+	};
+	search::bidirectional<IndexedPriorityQueue<double>>(*this, ReversedAdjacency<Graph>(*this), src->index, target->index,
+		potential, context);
+}
+
+vector<Vertex*> Graph::getPath(const BidirectionalContext& context) const {
+	vector<Vertex*> res;
+	if (context.meeting < 0)
+		return res;
+	for (int v = context.meeting; v != -1; v = context.forward.path[v])
+		res.push_back(vertexSet[v]);
+	reverse(res.begin(), res.end());
+	for (int v = context.backward.path[context.meeting]; v != -1; v = context.backward.path[v])
+		res.push_back(vertexSet[v]);
+	return res;
+}
+
+void Graph::dijkstraShortestPath(int sourceID) {
+	finalize();
+	dijkstraShortestPath(sourceID, searchContext);
+}
+
+vector<Vertex *> Graph::getPath(Vertex* dest, const SearchContext& context) const {
 	vector<Vertex *> res;
-	Vertex* v = dest;
-	if (v == NULL || v->dist == INF)
+	if (dest == NULL || context.dist.size() != vertexSet.size() || context.dist[dest->index] == INF)
 		return res;
-	while (v != NULL) {
-		res.push_back(v);
-		v = v->path;
-	}
+	for (int v = dest->index; v != -1; v = context.path[v])
+		res.push_back(vertexSet[v]);
 	reverse(res.begin(), res.end());
 	return res;
 }
 
-/***** P R I M ****/
+vector<Vertex *> Graph::getPath(Vertex* dest) const {
+	return getPath(dest, searchContext);
+}
 
-vector<Vertex*> Graph::calculatePrim() {
-	if (vertexSet.size() == 0)
-		return this->vertexSet;
-	// Reset auxiliary info
-	for(auto v : vertexSet) {
-		v->dist = INF;v->path = nullptr;
-		v->visited = false; // known(v) in slides	
-	}
-	
-	// start with an arbitrary vertex
-	Vertex* s = vertexSet.front();
-	s->dist = 0;
-	
-	// initializepriority queue
-	MutablePriorityQueue<Vertex> q;
-	q.insert(s);
+double Graph::getDist(Vertex* dest) const {
+	if (dest == NULL || searchContext.dist.size() != vertexSet.size())
+		return INF;
+	return searchContext.dist[dest->index];
+}
 
-	vector<Vertex*> order;
+/***** P R I M ****/
 
-	// process vertices in the priority queue
-	while (!q.empty()) {
-		Vertex* v = q.extractMin();
-		v->visited = true;
-		order.push_back(v);
-		for (Edge* e : v->adj) {
-			Vertex* w = e->dest;
-			if (!w->visited) {
-				auto oldDist = w->dist;
-				if (e->weight < w->dist) {
-					w->dist = e->weight;
-					w->path = v;
-					if (oldDist == INF)
-						q.insert(w);
-					else q.decreaseKey(w);
-				}
-			}
-		}
-	}
+vector<Vertex*> Graph::calculatePrim(SearchContext& context) const {
+	vector<Vertex*> order;
+	for (unsigned v : search::prim<IndexedPriorityQueue<double>>(*this, context))
+		order.push_back(vertexSet[v]);
 	return order;
 }
 
+vector<Vertex*> Graph::calculatePrim() {
+	finalize();
+	return calculatePrim(searchContext);
+}
+
 
 /***** Strongly Connected ****/
 
 bool Graph::stronglyConnected() {
-	BFS(vertexSet.front());
+	finalize();
+	SearchContext context;
+	BFS(vertexSet.front(), context);
 	for (auto v : vertexSet) {
-		if (!v->visited)
+		if (!context.visited[v->index])
 			return false;
 	}
 
 	Graph transposed;
 
 	transpose(&transposed);
-	transposed.BFS(transposed.vertexSet.front());
+	transposed.finalize();
+	transposed.BFS(transposed.vertexSet.front(), context);
 	for (auto v : transposed.vertexSet) {
-		if (!v->visited)
+		if (!context.visited[v->index])
 			return false;
 	}
 
@@ -319,13 +568,13 @@ bool Graph::stronglyConnected() {
 
 /***** Connected between points of interest (ignoring a vertex) ****/
 
-bool Graph::verifyConnectivity(const vector<Vertex*>& POIs, Vertex* removed) {
+bool Graph::verifyConnectivity(const vector<Vertex*>& POIs, Vertex* removed, SearchContext& context) const {
 	for (Vertex* v : POIs)
 		if (v->getID() == removed->getID())
 			return true;
-	BFS(POIs[0], removed);
+	BFS(POIs[0], removed, context);
 	for (Vertex* v : POIs) {
-		if (v->visited == false)
+		if (!context.visited[v->index])
 			return false;
 	}
 	return true;
@@ -336,9 +585,11 @@ vector<Vertex *> Graph::articulationPoints(const vector<Vertex*>& POIs) {
 	vector<Vertex *> articulationPoints;
 	if (POIs.size() == 0)
 		return articulationPoints;
+	finalize();
+	SearchContext context;
 	for (auto v : vertexSet){
-		if (!verifyConnectivity(POIs, v))
+		if (!verifyConnectivity(POIs, v, context))
 			articulationPoints.push_back(v);
 	}
 	return articulationPoints;
-}
+}
\ No newline at end of file
@@ -6,11 +6,13 @@
 #include <list>
 #include <climits>
 #include <cmath>
-#include "MutablePriorityQueue.h"
+#include <algorithm>
+#include "IndexedPriorityQueue.h"
+#include "ObjectPool.h"
+#include "FlatHashMap.h"
+#include "SearchContext.h"
 #include "PathMatrix.h"
 
-#define INF (std::numeric_limits<double>::max)()
-
 using namespace std;
 
 class Edge;
@@ -25,6 +27,7 @@ class Edge {
 	Vertex * dest;      // destination vertex
 	double weight;      // edge weight
 	int ID;
+	Edge * next = NULL; // next outgoing edge of the same vertex
 public:
 	Edge(int ID, Vertex *d, double w);
 	Vertex* getDest();
@@ -32,6 +35,32 @@ public:
 	double getWeight();
 	friend class Graph;
 	friend class Vertex;
+	friend class EdgeList;
+};
+
+
+/*********************** EdgeList  *************************/
+
+// Read-only view of the outgoing edges of a vertex, iterated without copying them into a vector
+class EdgeList {
+	Edge* first;
+	unsigned count;
+public:
+	class iterator {
+		Edge* edge;
+	public:
+		iterator(Edge* edge) : edge(edge) {}
+		Edge* operator*() const { return edge; }
+		iterator& operator++() { edge = edge->next; return *this; }
+		bool operator==(const iterator& other) const { return edge == other.edge; }
+		bool operator!=(const iterator& other) const { return edge != other.edge; }
+	};
+
+	EdgeList(Edge* first, unsigned count) : first(first), count(count) {}
+	iterator begin() const { return iterator(first); }
+	iterator end() const { return iterator(NULL); }
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
 };
 
 
@@ -40,56 +69,161 @@ public:
 
 class Vertex {
 	int ID;
+	unsigned index;       // dense index in vertexSet (and in the CSR arrays)
 	double x, y;
-	vector<Edge*> adj;  // outgoing edges
-
-	// auxiliary...
-	bool visited;         
-	double dist = 0;
-	Vertex *path = NULL;
-	int queueIndex = 0; 		// required by MutablePriorityQueue
-	bool processing = false;
-	void addEdge(int ID, Vertex *dest, double w);
+	Edge* firstEdge = NULL;  // outgoing edges, as a list of pool allocated edges
+	Edge* lastEdge = NULL;
+	unsigned outDegree = 0;
+	void addEdge(Edge* edge);
 public:
 	Vertex(int ID, double x, double y);
-	bool operator<(Vertex & vertex) const; // // required by MutablePriorityQueue
+	unsigned getIndex() const;
 	int getID() const;
 	double getX() const;
 	double getY() const;
-	double getDist() const;
-	vector<Edge*> getAdj() const;
-	Vertex *getPath() const;
+	EdgeList getAdj() const;
 
 	friend class Graph;
-	friend class MutablePriorityQueue<Vertex>;
 };
 
 
 /*************************** Graph  **************************/
 
+// Records used to build a whole graph at once (see Graph::addVertices / Graph::addEdges)
+struct VertexRecord {
+	int ID;
+	double x, y;
+};
+
+struct EdgeRecord {
+	unsigned srcIndex, destIndex;   // dense vertex indexes
+	int ID;
+	double weight;
+};
+
 class Graph {
 	vector<vector<double>> Dist;
 	vector<vector<int>> Path;
 	vector<Vertex *> vertexSet;    // vertex set
+	vector<double> xs, ys;         // vertex coordinates, indexed by dense index
+	vector<int> latsE7, lonsE7;    // latitude/longitude in 1e-7 degrees, indexed by dense index (empty if not known)
+
+	// Every vertex and edge of the graph is owned by these pools
+	ObjectPool<Vertex> vertexPool;
+	ObjectPool<Edge> edgePool;
+
+	// Lookup indexes
+	FlatHashMap<int, unsigned> idToIndex;                // vertex ID -> dense index
+	vector<Edge *> edgesByID;                            // edge ID -> edge
+	FlatHashMap<unsigned long long, Edge *> edgeIndex;   // (src index, dest index) -> edge
+
+	// Compressed sparse row snapshot of the adjacency lists, used by the search algorithms.
+	// The outgoing edges of vertexSet[i] are [csrOffsets[i], csrOffsets[i + 1]).
+	vector<unsigned> csrOffsets;
+	vector<unsigned> csrTargets;   // dense index of the destination vertex
+	vector<double> csrWeights;
+	vector<int> csrEdgeIDs;
+	bool csrValid = false;
+	void buildCSR();
+
+	// The same edges grouped by destination, for backward searches: the incoming edges of vertexSet[i]
+	// are [reverseOffsets[i], reverseOffsets[i + 1]).
+	vector<unsigned> reverseOffsets;
+	vector<unsigned> reverseSources;   // dense index of the source vertex
+	vector<double> reverseWeights;
+
+	// Largest factor by which the straight-line X/Y distance between the ends of an edge never exceeds its weight,
+	// so scale * distance to the target is a consistent A* heuristic whatever the weights are (e.g. geodesic ones)
+	double heuristicScale = 0;
+	void finishCSR();	// builds the reverse adjacency and the heuristic scale from the CSR arrays
+
+	SearchContext searchContext;   // used by the overloads that don't take a context
 public:
+	Graph() {}
+	Graph(const Graph&) = delete;
+	Graph& operator=(const Graph&) = delete;
+
+	void reserve(size_t numVertices, size_t numEdges);
 	Vertex* findVertex(int id) const;
 	Edge* findEdge(int id) const;
+	Edge* findEdge(const Vertex* src, const Vertex* dest) const;
 	bool addVertex(int ID, double x, double y);
 	bool addEdge(int edgeID, int srcID, int destID, double w);
+	void addVertices(const vector<VertexRecord>& vertices);
+	void addEdges(const vector<EdgeRecord>& edges);
+	bool addCSR(size_t numVertices, const int* ids, const double* xs, const double* ys,
+		const unsigned* offsets, const unsigned* targets, const double* weights, const int* edgeIDs);
 	size_t getNumVertex() const;
-	vector<Vertex *> getVertexSet() const;
+	const vector<Vertex *>& getVertexSet() const;
+	const vector<double>& getXs() const;
+	const vector<double>& getYs() const;
+	// Geographic coordinates, kept as fixed point 1e-7 degrees (the precision of the lat/lon files)
+	void setGeoCoordinates(vector<int> latsE7, vector<int> lonsE7);
+	bool hasGeoCoordinates() const;
+	const vector<int>& getLatsE7() const;
+	const vector<int>& getLonsE7() const;
+	double getLat(unsigned index) const;
+	double getLon(unsigned index) const;
+	// CSR arrays, valid after finalize()
+	const vector<unsigned>& getCSROffsets() const;
+	const vector<unsigned>& getCSRTargets() const;
+	const vector<double>& getCSRWeights() const;
+	const vector<int>& getCSREdgeIDs() const;
+	size_t getNumEdges() const;
+	size_t getMemoryUsage() const;	// approximate heap usage, in bytes
+	void finalize();
+	double getHeuristicScale() const;	// valid after finalize()
+
+	/**
+	 * Calls visit(dest, weight) for every outgoing edge of vertex v (dense indexes). Valid after finalize().
+	 */
+	template <class Visitor>
+	void forEachEdge(unsigned v, Visitor visit) const {
+		for (unsigned e = csrOffsets[v]; e < csrOffsets[v + 1]; e++)
+			visit(csrTargets[e], csrWeights[e]);
+	}
+
+	/**
+	 * Calls visit(src, weight) for every incoming edge of vertex v (dense indexes). Valid after finalize().
+	 */
+	template <class Visitor>
+	void forEachIncomingEdge(unsigned v, Visitor visit) const {
+		for (unsigned e = reverseOffsets[v]; e < reverseOffsets[v + 1]; e++)
+			visit(reverseSources[e], reverseWeights[e]);
+	}
+
+	// The const searches below only read the graph, so they may run concurrently
+	// (each with its own SearchContext) once finalize() has been called.
+	void BFS(Vertex* s, SearchContext& context) const;
+	void BFS(Vertex* s, Vertex* removed, SearchContext& context) const;
+	void dijkstraShortestPath(int sourceID, SearchContext& context) const;
+	/**
+	 * A* from sourceID to targetID, guided by the straight-line distance to the target. Stops once the target is
+	 * settled, so only its distance and path in the context (read as after dijkstraShortestPath) are final.
+	 * Returns the number of settled vertices.
+	 */
+	size_t aStarShortestPath(int sourceID, int targetID, SearchContext& context) const;
+	/**
+	 * Bidirectional Dijkstra from sourceID to targetID: a forward search on the outgoing edges and a backward one
+	 * on the incoming edges, stopped once no shorter path can be found. The result is in context.
+	 */
+	void bidirectionalDijkstra(int sourceID, int targetID, BidirectionalContext& context) const;
+	// Bidirectional A*, with the average of the straight-line distances to the target and from the source as potential
+	void bidirectionalAStar(int sourceID, int targetID, BidirectionalContext& context) const;
+	vector<Vertex*> getPath(const BidirectionalContext& context) const;
+	vector<Vertex*> getPath(Vertex* v, const SearchContext& context) const;
+	vector<Vertex*> calculatePrim(SearchContext& context) const;
+	bool verifyConnectivity(const vector<Vertex*>& POIids, Vertex* removed, SearchContext& context) const;
 
-	void BFS(Vertex* s);
-	void BFS(Vertex* s, Vertex* removed);
 	void transpose(Graph* transposed);
-	PathMatrix* multipleDijkstra(const vector<int>& POIids);
+	PathMatrix multipleDijkstra(const vector<int>& POIids);
 	void dijkstraShortestPath(int sourceID);
 	vector<Vertex*> getPath(Vertex* v) const;
+	double getDist(Vertex* v) const;
 
 
 	vector<Vertex*> calculatePrim();
 	bool stronglyConnected();
-	bool verifyConnectivity(const vector<Vertex*>& POIids, Vertex* removed);
 	vector<Vertex *> articulationPoints(const vector<Vertex*>& POIids);
 
 };
@@ -1,75 +1,386 @@
 #include "GraphBuilder.h"
+#include "Geometry.h"
+#include "GraphFileParser.h"
+#include "MappedFile.h"
+#include "GraphSnapshot.h"
+#include "ThreadPool.h"
+#include "ArtifactCache.h"
+#include "SearchAlgorithms.h"
 
-struct VertexInfo {
-	int ID;
-	double x, y;
-	VertexInfo(string line) {
+unique_ptr<Graph> GraphBuilder::build() {
+	if (snapshotPath.empty() && cache == NULL)
+		return buildRegionOrFull();
 
-		for (size_t i = 0; i < line.size(); i++) {
-			if (line[i] == '(' || line[i] == ',' || line[i] == ')')
-				line[i] = ' ';
-		}
-		
-		istringstream iss(line);
-		iss >> ID >> x >> y;
-	}
-};
-
-struct EdgeInfo {
-	int srcID, destID;
-	double weight;
-	EdgeInfo(string line) {
-		for (size_t i = 0; i < line.size(); i++) {
-			if (line[i] == '(' || line[i] == ',' || line[i] == ')')
-				line[i] = ' ';
+	unsigned long long key = sourceKey();
+	string path = cache != NULL ? cache->getPath("graph", key) : snapshotPath;
+	{
+		GraphSnapshot snapshot(path);
+		if (snapshot.isValid() && snapshot.getSourceKey() == key) {
+			unique_ptr<Graph> graph = snapshot.toGraph();
+			if (graph->getNumVertex() > 0)
+				return graph;
 		}
+	}
+
+	// No usable snapshot (missing, stale or damaged): parse the text files and replace it
+	unique_ptr<Graph> graph = buildRegionOrFull();
+	if (graph->getNumVertex() > 0 && !GraphSnapshot::write(*graph, path, key))
+		cout << "Warning: couldn't write graph snapshot " << path << endl;
+	return graph;
+}
+
+// Changes whenever the contents of one of the input files, the vertex order or the use of lat/lon coordinates do
+unsigned long long GraphBuilder::sourceKey() const {
+	unsigned long long key = ArtifactCache::hashFile(nodeFilePath);
+	key = ArtifactCache::combine(key, ArtifactCache::hashFile(edgeFilePath));
+	key = ArtifactCache::combine(key, latLonFilePath.empty() ? 0 : ArtifactCache::hashFile(latLonFilePath));
+	key = ArtifactCache::combine(key, (unsigned long long)vertexOrder);
+	if (!regionIDs.empty()) {
+		vector<int> ids = regionIDs;
+		sort(ids.begin(), ids.end());
+		key = ArtifactCache::combine(key, ArtifactCache::hashBytes(ids.data(), ids.size() * sizeof(int)));
+		key = ArtifactCache::combine(key, ArtifactCache::hashBytes(&regionPadding, sizeof(double)));
+	}
+	return key;
+}
+
+// The region of interest if there's one and it connects its vertices, else the whole graph
+unique_ptr<Graph> GraphBuilder::buildRegionOrFull() const {
+	if (regionIDs.empty())
+		return buildFromText(false);
+	unique_ptr<Graph> graph = buildFromText(true);
+	if (graph->getNumVertex() > 0 && regionIsConnected(*graph))
+		return graph;
+	cout << "The region of interest doesn't connect all of its vertices, building the whole graph" << endl;
+	return buildFromText(false);
+}
 
-		istringstream iss(line);
-		iss >> srcID >> destID;
+// Whether every vertex of regionIDs is in the graph and reachable from the others
+bool GraphBuilder::regionIsConnected(const Graph& graph) const {
+	vector<unsigned> indexes;
+	for (int id : regionIDs) {
+		Vertex* v = graph.findVertex(id);
+		if (v == NULL)
+			return false;
+		indexes.push_back(v->getIndex());
 	}
-};
+	// The built graphs have every road in both directions, so one search from any vertex is enough
+	SearchContext context;
+	search::bfs(graph, indexes[0], context);
+	for (unsigned v : indexes) {
+		if (!context.visited[v])
+			return false;
+	}
+	return true;
+}
+
+// Parses the chunks of a file on the pool, then concatenates them (in file order) in parallel
+template <class Record, class Parser>
+static void parseInChunks(ThreadPool* pool, const MappedFile& file, size_t numChunks, Parser parse, vector<Record>& records) {
+	vector<const char*> bounds = graphfile::splitLines(file.begin(), file.end(), numChunks);
+	numChunks = bounds.size() - 1;
+	if (numChunks == 1) {
+		parse(bounds[0], bounds[1], records);
+		return;
+	}
+
+	vector<vector<Record>> chunks(numChunks);
+	forEachChunk(pool, numChunks, [&](size_t i) { parse(bounds[i], bounds[i + 1], chunks[i]); });
 
-Graph* GraphBuilder::build() {
-	Graph* graph = new Graph;
+	vector<size_t> starts(numChunks + 1, 0);
+	for (size_t i = 0; i < numChunks; i++)
+		starts[i + 1] = starts[i] + chunks[i].size();
+	records.resize(starts[numChunks]);
+	forEachChunk(pool, numChunks, [&](size_t i) { copy(chunks[i].begin(), chunks[i].end(), records.begin() + starts[i]); });
+}
 
-	ifstream nodeFile(this->nodeFilePath);
-	ifstream edgeFile(this->edgeFilePath);
+unique_ptr<Graph> GraphBuilder::buildFromText(bool cropToRegion) const {
+	unique_ptr<Graph> graph(new Graph);
 
-	if (nodeFile.fail()) {
+	MappedFile nodeFile(this->nodeFilePath);
+	MappedFile edgeFile(this->edgeFilePath);
+
+	if (!nodeFile.isOpen()) {
 		cout << "Couldn't open node file: " << this->nodeFilePath << endl;
 		return graph;
 	}
 
-	if (edgeFile.fail()) {
+	if (!edgeFile.isOpen()) {
 		cout << "Couldn't open edge file: " << this->edgeFilePath << endl;
 		return graph;
 	}
 
-	string line;
+	unique_ptr<MappedFile> latLonFile;
+	if (!latLonFilePath.empty()) {
+		latLonFile.reset(new MappedFile(latLonFilePath));
+		if (!latLonFile->isOpen()) {
+			cout << "Couldn't open lat/lon file: " << this->latLonFilePath << endl;
+			return graph;
+		}
+	}
+
+	unique_ptr<ThreadPool> pool;
+	if (numThreads > 1)
+		pool.reset(new ThreadPool(numThreads));
+	size_t numChunks = numThreads > 1 ? 4 * numThreads : 1;	// more chunks than threads, to even out their sizes
 
-	while (getline(nodeFile, line)) {
-		VertexInfo v(line);
-		graph->addVertex(v.ID, v.x, v.y);
+	// Read every record first, so the graph can be built in bulk
+	vector<VertexRecord> vertices;
+	parseInChunks(pool.get(), nodeFile, numChunks, graphfile::parseNodes, vertices);
+
+	vector<EdgeIDRecord> edgeLines;
+	parseInChunks(pool.get(), edgeFile, numChunks, graphfile::parseEdges, edgeLines);
+
+	// Drop repeated vertex IDs (the first one wins, as in Graph::addVertex), so that
+	// a record's position is its dense index
+	FlatHashMap<int, unsigned> idToIndex;
+	idToIndex.reserve(vertices.size());
+	size_t numVertices = 0;
+	for (const VertexRecord& v : vertices) {
+		if (idToIndex.find(v.ID) != NULL)
+			continue;
+		idToIndex[v.ID] = (unsigned)numVertices;
+		vertices[numVertices++] = v;
 	}
+	vertices.resize(numVertices);
 
-	int edgeId = 0;
-	while (getline(edgeFile, line)) {
-		EdgeInfo e(line);
-		Vertex* src = graph->findVertex(e.srcID);
-		Vertex* dest = graph->findVertex(e.destID);
-		if (src == NULL) {
+	// Resolve the edge endpoints in chunks. Each chunk stops at its first unknown ID, and the first one
+	// in file order is reported, so the error is the same for any number of threads.
+	vector<unsigned> srcIndexes(edgeLines.size()), destIndexes(edgeLines.size());
+	size_t edgeChunkSize = (edgeLines.size() + numChunks - 1) / numChunks;
+	vector<size_t> firstError(numChunks, edgeLines.size());
+	forEachChunk(pool.get(), numChunks, [&](size_t chunk) {
+		size_t last = min(edgeLines.size(), (chunk + 1) * edgeChunkSize);
+		for (size_t i = chunk * edgeChunkSize; i < last; i++) {
+			const unsigned* src = idToIndex.find(edgeLines[i].srcID);
+			const unsigned* dest = idToIndex.find(edgeLines[i].destID);
+			if (src == NULL || dest == NULL) {
+				firstError[chunk] = i;
+				return;
+			}
+			srcIndexes[i] = *src;
+			destIndexes[i] = *dest;
+		}
+	});
+	size_t error = *min_element(firstError.begin(), firstError.end());
+	if (error < edgeLines.size()) {
+		const EdgeIDRecord& e = edgeLines[error];
+		if (idToIndex.find(e.srcID) == NULL)
 			cout << "Error: Couldn't find vertex with srcID = " << e.srcID << endl;
-			throw exception();
+		else cout << "Error: Couldn't find vertex with destID = " << e.destID << endl;
+		throw exception();
+	}
+
+	// Keep only the region of interest: the vertices inside the padded bounding box of regionIDs
+	// and the edges between them (renumbered, so the graph is as compact as if the files held only them)
+	if (cropToRegion) {
+		double minX = INF, minY = INF, maxX = -INF, maxY = -INF;
+		for (int id : regionIDs) {
+			const unsigned* index = idToIndex.find(id);
+			if (index == NULL)
+				continue;
+			minX = min(minX, vertices[*index].x); maxX = max(maxX, vertices[*index].x);
+			minY = min(minY, vertices[*index].y); maxY = max(maxY, vertices[*index].y);
 		}
-		if (dest == NULL) {
-			cout << "Error: Couldn't find vertex with destID = " << e.destID << endl;
-			throw exception();
+		minX -= regionPadding; maxX += regionPadding;
+		minY -= regionPadding; maxY += regionPadding;
+
+		vector<unsigned> newIndex(vertices.size(), UINT_MAX);
+		size_t numInside = 0;
+		for (size_t i = 0; i < vertices.size(); i++) {
+			VertexRecord v = vertices[i];
+			if (v.x >= minX && v.x <= maxX && v.y >= minY && v.y <= maxY) {
+				newIndex[i] = (unsigned)numInside;
+				vertices[numInside++] = v;
+			}
+		}
+		vertices.resize(numInside);
+
+		size_t numKept = 0;
+		for (size_t i = 0; i < srcIndexes.size(); i++) {
+			unsigned src = newIndex[srcIndexes[i]], dest = newIndex[destIndexes[i]];
+			if (src == UINT_MAX || dest == UINT_MAX)
+				continue;
+			srcIndexes[numKept] = src;
+			destIndexes[numKept] = dest;
+			numKept++;
+		}
+		srcIndexes.resize(numKept);
+		destIndexes.resize(numKept);
+	}
+
+	// Edge weights are the lengths of the roads, computed in one batch: geodesic if the
+	// lat/lon coordinates were given, otherwise euclidean over X/Y
+	vector<double> lengths(srcIndexes.size());
+	vector<int> latsE7, lonsE7;
+	if (latLonFile) {
+		vector<double> lats, lons;
+		readLatLon(pool.get(), *latLonFile, numChunks, vertices, lats, lons);
+		geometry::geodesicLengths(lats.data(), lons.data(), vertices.size(), srcIndexes.data(), destIndexes.data(), lengths.data(), lengths.size());
+		latsE7.resize(vertices.size());
+		lonsE7.resize(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++) {
+			latsE7[i] = (int)lround(lats[i] * 1e7);
+			lonsE7[i] = (int)lround(lons[i] * 1e7);
+		}
+	}
+	else {
+		vector<double> xs(vertices.size()), ys(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++) {
+			xs[i] = vertices[i].x;
+			ys[i] = vertices[i].y;
 		}
+		geometry::edgeLengths(xs.data(), ys.data(), srcIndexes.data(), destIndexes.data(), lengths.data(), lengths.size());
+	}
+
+	vector<EdgeRecord> edges;
+	edges.reserve(srcIndexes.size() * 2);
+	int edgeId = 0;
+	for (size_t i = 0; i < srcIndexes.size(); i++) {
+		edges.push_back({ srcIndexes[i], destIndexes[i], edgeId++, lengths[i] });
+		edges.push_back({ destIndexes[i], srcIndexes[i], edgeId++, lengths[i] }); // undirected ( test ) :D
+	}
 
-		double dist = sqrt(pow(src->getX() - dest->getX(), 2) + pow(src->getY() - dest->getY(), 2));
-		graph->addEdge(edgeId++, e.srcID, e.destID, dist);
-		graph->addEdge(edgeId++, e.destID, e.srcID, dist); // undirected ( test ) :D
+	if (vertexOrder != InputOrder) {
+		vector<unsigned> order = reorder(vertices, edges);
+		if (!latsE7.empty()) {
+			vector<int> lats(order.size()), lons(order.size());
+			for (size_t i = 0; i < order.size(); i++) {
+				lats[i] = latsE7[order[i]];
+				lons[i] = lonsE7[order[i]];
+			}
+			latsE7.swap(lats);
+			lonsE7.swap(lons);
+		}
 	}
 
+	graph->reserve(vertices.size(), edges.size());
+	graph->addVertices(vertices);
+	graph->addEdges(edges);
+	if (!latsE7.empty())
+		graph->setGeoCoordinates(move(latsE7), move(lonsE7));
+	graph->finalize();
 	return graph;
+}
+
+// Latitude and longitude of each vertex (in the order of vertices), from the lat/lon file.
+// Its lines have the same "(ID, lat, lon)" format as the node file.
+void GraphBuilder::readLatLon(ThreadPool* pool, const MappedFile& file, size_t numChunks, const vector<VertexRecord>& vertices,
+	vector<double>& lats, vector<double>& lons) {
+	vector<VertexRecord> records;
+	parseInChunks(pool, file, numChunks, graphfile::parseNodes, records);
+
+	FlatHashMap<int, unsigned> idToRecord;
+	idToRecord.reserve(records.size());
+	for (unsigned i = 0; i < records.size(); i++) {
+		if (idToRecord.find(records[i].ID) == NULL)
+			idToRecord[records[i].ID] = i;
+	}
+
+	lats.resize(vertices.size());
+	lons.resize(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++) {
+		const unsigned* record = idToRecord.find(vertices[i].ID);
+		if (record == NULL) {
+			cout << "Error: Couldn't find the lat/lon of vertex with ID = " << vertices[i].ID << endl;
+			throw exception();
+		}
+		lats[i] = records[*record].x;
+		lons[i] = records[*record].y;
+	}
+}
+
+/*** Vertex renumbering ***/
+
+// Position of the point (x, y) of a 2^16 x 2^16 grid along the Hilbert curve
+static unsigned long long hilbertKey(unsigned x, unsigned y) {
+	const unsigned n = 1u << 16;
+	unsigned long long d = 0;
+	for (unsigned s = n / 2; s > 0; s /= 2) {
+		unsigned rx = (x & s) > 0;
+		unsigned ry = (y & s) > 0;
+		d += (unsigned long long)s * s * ((3 * rx) ^ ry);
+		if (ry == 0) {
+			if (rx == 1) {
+				x = n - 1 - x;
+				y = n - 1 - y;
+			}
+			swap(x, y);
+		}
+	}
+	return d;
+}
+
+static vector<unsigned> hilbertOrder(const vector<VertexRecord>& vertices) {
+	double minX = INF, minY = INF, maxX = -INF, maxY = -INF;
+	for (const VertexRecord& v : vertices) {
+		minX = min(minX, v.x); maxX = max(maxX, v.x);
+		minY = min(minY, v.y); maxY = max(maxY, v.y);
+	}
+	double scale = 65535.0 / max(max(maxX - minX, maxY - minY), 1e-9);
+
+	vector<pair<unsigned long long, unsigned>> keys(vertices.size());
+	for (unsigned i = 0; i < vertices.size(); i++) {
+		unsigned x = (unsigned)((vertices[i].x - minX) * scale);
+		unsigned y = (unsigned)((vertices[i].y - minY) * scale);
+		keys[i] = make_pair(hilbertKey(x, y), i);
+	}
+	sort(keys.begin(), keys.end());
+
+	vector<unsigned> order(vertices.size());
+	for (size_t i = 0; i < keys.size(); i++)
+		order[i] = keys[i].second;
+	return order;
+}
+
+static vector<unsigned> bfsOrder(size_t numVertices, const vector<EdgeRecord>& edges) {
+	vector<unsigned> offsets(numVertices + 1, 0), targets(edges.size());
+	for (const EdgeRecord& e : edges)
+		offsets[e.srcIndex + 1]++;
+	for (size_t i = 0; i < numVertices; i++)
+		offsets[i + 1] += offsets[i];
+	vector<unsigned> next(offsets.begin(), offsets.end() - 1);
+	for (const EdgeRecord& e : edges)
+		targets[next[e.srcIndex]++] = e.destIndex;
+
+	vector<unsigned> order;
+	order.reserve(numVertices);
+	vector<char> visited(numVertices, false);
+	for (unsigned root = 0; root < numVertices; root++) {
+		if (visited[root])
+			continue;
+		// order doubles as the BFS queue
+		size_t head = order.size();
+		visited[root] = true;
+		order.push_back(root);
+		while (head < order.size()) {
+			unsigned v = order[head++];
+			for (unsigned e = offsets[v]; e < offsets[v + 1]; e++) {
+				if (!visited[targets[e]]) {
+					visited[targets[e]] = true;
+					order.push_back(targets[e]);
+				}
+			}
+		}
+	}
+	return order;
+}
+
+// Renumbers the vertices in vertexOrder. Returns the order: the new index i is the old index order[i].
+vector<unsigned> GraphBuilder::reorder(vector<VertexRecord>& vertices, vector<EdgeRecord>& edges) const {
+	vector<unsigned> order = vertexOrder == HilbertOrder ? hilbertOrder(vertices) : bfsOrder(vertices.size(), edges);
+
+	vector<unsigned> newIndex(vertices.size());
+	vector<VertexRecord> reordered(vertices.size());
+	for (unsigned i = 0; i < order.size(); i++) {
+		newIndex[order[i]] = i;
+		reordered[i] = vertices[order[i]];
+	}
+	vertices.swap(reordered);
+
+	for (EdgeRecord& e : edges) {
+		e.srcIndex = newIndex[e.srcIndex];
+		e.destIndex = newIndex[e.destIndex];
+	}
+	return order;
 }
\ No newline at end of file
@@ -6,16 +6,82 @@
 #include <string>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 
 using namespace std;
 
+class MappedFile;
+class ThreadPool;
+class ArtifactCache;
+
 class GraphBuilder {
+public:
+	// Order of the dense vertex indexes of the built graph (vertex IDs are never changed)
+	enum VertexOrder {
+		InputOrder,		// order of the node file
+		HilbertOrder,	// along a Hilbert curve over the X/Y coordinates
+		BFSOrder		// breadth first order of the road network
+	};
+private:
 	string nodeFilePath;
 	string edgeFilePath;
+	string latLonFilePath;
+	VertexOrder vertexOrder = InputOrder;
+	string snapshotPath;
+	const ArtifactCache* cache = NULL;
+	unsigned numThreads = 1;
+	vector<int> regionIDs;		// vertices whose bounding box (plus regionPadding) is kept, if any
+	double regionPadding = 0;
+
+	unique_ptr<Graph> buildRegionOrFull() const;
+	unique_ptr<Graph> buildFromText(bool cropToRegion) const;
+	bool regionIsConnected(const Graph& graph) const;
+	static void readLatLon(ThreadPool* pool, const MappedFile& file, size_t numChunks, const vector<VertexRecord>& vertices,
+		vector<double>& lats, vector<double>& lons);
+	vector<unsigned> reorder(vector<VertexRecord>& vertices, vector<EdgeRecord>& edges) const;
+	unsigned long long sourceKey() const;
 public:
 
 	GraphBuilder(string nodeFilePath, string edgeFilePath) : nodeFilePath(nodeFilePath), edgeFilePath(edgeFilePath) {}
 
-	Graph* build();
+	GraphBuilder& setVertexOrder(VertexOrder order) { vertexOrder = order; return *this; }
+
+	/**
+	 * Also reads the latitude and longitude of every vertex from a T05_nodes_lat_lon file. The graph keeps them
+	 * (see Graph::getLat) and the edge weights become geodesic lengths in metres instead of X/Y euclidean lengths.
+	 */
+	GraphBuilder& setLatLonFilePath(const string& path) { latLonFilePath = path; return *this; }
+
+	/**
+	 * Keeps a GraphSnapshot of the built graph at path. build() loads it instead of the text files while the
+	 * contents of the files and the options are the same as when it was written. This skips the parsing, but the
+	 * Graph is still rebuilt from the snapshot (GraphSnapshot::toGraph).
+	 */
+	GraphBuilder& setSnapshotPath(const string& path) { snapshotPath = path; return *this; }
+
+	/**
+	 * Keeps the GraphSnapshot in an ArtifactCache instead, named by the key of the files and options
+	 * (takes precedence over setSnapshotPath).
+	 */
+	GraphBuilder& setArtifactCache(const ArtifactCache& artifactCache) { cache = &artifactCache; return *this; }
+
+	/**
+	 * Number of threads used to parse the text files (split in chunks of whole lines) and resolve the edges.
+	 * The built graph is the same for any number of threads.
+	 */
+	GraphBuilder& setNumThreads(unsigned threads) { numThreads = max(threads, 1u); return *this; }
+
+	/**
+	 * Builds only the part of the graph inside the bounding box of the given vertices (usually the PoIs),
+	 * widened by padding on every side (in X/Y units): the vertices inside it and the edges between them.
+	 * If the vertices aren't all connected to each other inside the region, the whole graph is built instead.
+	 * Paths that would leave the region are not seen, so padding should leave room for detours.
+	 */
+	GraphBuilder& setRegionOfInterest(const vector<int>& vertexIDs, double padding) {
+		regionIDs = vertexIDs;
+		regionPadding = padding;
+		return *this;
+	}
+	unique_ptr<Graph> build();
 };
 
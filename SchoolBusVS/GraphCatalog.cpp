@@ -0,0 +1,137 @@
+#include "GraphCatalog.h"
+#include "GraphBuilder.h"
+#include <filesystem>
+
+GraphCatalog::GraphCatalog(const string& graphsDirectory, size_t memoryBudget) : memoryBudget(memoryBudget) {
+	error_code error;
+	filesystem::directory_iterator directory(graphsDirectory, error);
+	if (error) {
+		cout << "Couldn't open graphs directory: " << graphsDirectory << endl;
+		return;
+	}
+	for (const filesystem::directory_entry& entry : directory) {
+		if (!entry.is_directory(error))
+			continue;
+		string name = entry.path().filename().string();
+		filesystem::path dir = entry.path();
+		CityFiles files;
+		files.nodeFilePath = (dir / ("T05_nodes_X_Y_" + name + ".txt")).string();
+		files.edgeFilePath = (dir / ("T05_edges_" + name + ".txt")).string();
+		if (!filesystem::exists(files.nodeFilePath, error) || !filesystem::exists(files.edgeFilePath, error))
+			continue;	// e.g. a directory with only the tags
+		filesystem::path latLon = dir / ("T05_nodes_lat_lon_" + name + ".txt");
+		filesystem::path tags = dir / ("T05_tags_" + name + ".txt");
+		if (filesystem::exists(latLon, error))
+			files.latLonFilePath = latLon.string();
+		if (filesystem::exists(tags, error))
+			files.tagFilePath = tags.string();
+		files.snapshotPath = (dir / (name + ".snapshot")).string();
+		cities[name] = files;
+		names.push_back(name);
+	}
+	sort(names.begin(), names.end());
+}
+
+shared_ptr<CityGraph> GraphCatalog::load(const string& name) const {
+	const CityFiles& files = cities.at(name);
+	GraphBuilder builder(files.nodeFilePath, files.edgeFilePath);
+	builder.setVertexOrder(GraphBuilder::BFSOrder).setNumThreads(numThreads);
+	if (cache != NULL)
+		builder.setArtifactCache(*cache);
+	else builder.setSnapshotPath(files.snapshotPath);
+	if (!files.latLonFilePath.empty())
+		builder.setLatLonFilePath(files.latLonFilePath);
+
+	shared_ptr<CityGraph> city(new CityGraph);
+	city->name = name;
+	try {
+		city->graph = builder.build();
+	}
+	catch (exception&) {
+		return NULL;
+	}
+	if (city->graph->getNumVertex() == 0)
+		return NULL;
+	if (!files.tagFilePath.empty())
+		city->tags = TagIndex(files.tagFilePath, *city->graph);
+	city->memoryUsage = city->graph->getMemoryUsage() + city->tags.getMemoryUsage();
+	return city;
+}
+
+// Drops the least recently used cities until the others fit in the budget (always keeps the most recent one)
+void GraphCatalog::evict() {
+	while (residentMemory > memoryBudget && resident.size() > 1) {
+		residentMemory -= resident.back()->memoryUsage;
+		resident.pop_back();
+		numEvictions++;
+	}
+}
+
+shared_ptr<const CityGraph> GraphCatalog::get(const string& name) {
+	if (!hasCity(name))
+		return NULL;
+	promise<shared_ptr<CityGraph>> loaded;
+	shared_future<shared_ptr<CityGraph>> otherLoad;
+	{
+		lock_guard<mutex> guard(lock);
+		for (auto it = resident.begin(); it != resident.end(); it++) {
+			if ((*it)->name == name) {
+				resident.splice(resident.begin(), resident, it);
+				return resident.front();
+			}
+		}
+		auto inFlight = loading.find(name);
+		if (inFlight != loading.end())
+			otherLoad = inFlight->second;
+		else loading[name] = loaded.get_future().share();
+	}
+	if (otherLoad.valid())	// another thread is loading it: wait for that instead of loading it twice
+		return otherLoad.get();
+
+	// Built without holding the lock, so the resident cities can still be used meanwhile
+	shared_ptr<CityGraph> city;
+	try {
+		city = load(name);
+	}
+	catch (...) {
+		lock_guard<mutex> guard(lock);
+		loading.erase(name);
+		loaded.set_exception(current_exception());
+		throw;
+	}
+
+	lock_guard<mutex> guard(lock);
+	loading.erase(name);
+	loaded.set_value(city);
+	if (city == NULL)
+		return NULL;
+	resident.push_front(city);
+	residentMemory += city->memoryUsage;
+	numLoads++;
+	evict();
+	return city;
+}
+
+bool GraphCatalog::isResident(const string& name) const {
+	lock_guard<mutex> guard(lock);
+	for (const shared_ptr<CityGraph>& city : resident) {
+		if (city->name == name)
+			return true;
+	}
+	return false;
+}
+
+size_t GraphCatalog::getResidentMemory() const {
+	lock_guard<mutex> guard(lock);
+	return residentMemory;
+}
+
+size_t GraphCatalog::getNumLoads() const {
+	lock_guard<mutex> guard(lock);
+	return numLoads;
+}
+
+size_t GraphCatalog::getNumEvictions() const {
+	lock_guard<mutex> guard(lock);
+	return numEvictions;
+}
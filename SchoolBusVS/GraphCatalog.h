@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <future>
+#include "Graph.h"
+#include "TagIndex.h"
+#include "ArtifactCache.h"
+
+using namespace std;
+
+// A loaded city: its graph and the tags of its vertices
+struct CityGraph {
+	string name;
+	unique_ptr<Graph> graph;
+	TagIndex tags;
+	size_t memoryUsage = 0;	// of the graph and the tags, in bytes, when they were loaded
+};
+
+/**
+ * The cities of a graphs directory (one subdirectory per city, with its T05_nodes_X_Y_<City>.txt and
+ * T05_edges_<City>.txt files, and optionally the lat/lon and tag files). A city is built on its first use
+ * and stays resident while the resident cities fit in the memory budget; past it, the least recently used
+ * ones are evicted. A CityGraph handed out stays valid while it's held, even if the catalog evicts it.
+ * The catalog can be used from several threads.
+ */
+class GraphCatalog {
+	struct CityFiles {
+		string nodeFilePath, edgeFilePath, latLonFilePath, tagFilePath, snapshotPath;
+	};
+
+	map<string, CityFiles> cities;
+	vector<string> names;
+	size_t memoryBudget;
+	unsigned numThreads = 1;
+	const ArtifactCache* cache = NULL;
+
+	mutable mutex lock;
+	list<shared_ptr<CityGraph>> resident;	// most recently used first
+	map<string, shared_future<shared_ptr<CityGraph>>> loading;	// cities being loaded, which other callers wait for
+	size_t residentMemory = 0;
+	size_t numLoads = 0, numEvictions = 0;
+
+	shared_ptr<CityGraph> load(const string& name) const;
+	void evict();
+public:
+	/**
+	 * Lists the cities of graphsDirectory; nothing is loaded yet.
+	 *
+	 * @param memoryBudget Bytes that the resident cities may use (the last city used is kept even if it's larger)
+	 */
+	GraphCatalog(const string& graphsDirectory, size_t memoryBudget);
+	GraphCatalog(const GraphCatalog&) = delete;
+	GraphCatalog& operator=(const GraphCatalog&) = delete;
+
+	// Number of threads used to parse the files of a city (see GraphBuilder::setNumThreads)
+	void setNumThreads(unsigned threads) { numThreads = max(threads, 1u); }
+
+	// Keeps the snapshots of the cities in cache, instead of next to their files
+	void setArtifactCache(const ArtifactCache* artifactCache) { cache = artifactCache; }
+
+	// Names of the cities, sorted
+	const vector<string>& getCityNames() const { return names; }
+	bool hasCity(const string& name) const { return cities.count(name) > 0; }
+
+	/**
+	 * The city with the given name, loaded now if it isn't resident (or waiting for the thread that's already
+	 * loading it). NULL if there's no such city or its graph couldn't be built.
+	 */
+	shared_ptr<const CityGraph> get(const string& name);
+
+	bool isResident(const string& name) const;
+	size_t getResidentMemory() const;
+	size_t getNumLoads() const;
+	size_t getNumEvictions() const;
+};
@@ -0,0 +1,209 @@
+#include "GraphFileParser.h"
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <climits>
+
+namespace {
+
+	// Powers of ten that are exact doubles
+	const double EXACT_POWERS_OF_10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	/**
+	 * Reads the fields of one line. Whitespace before each field is skipped, like sscanf does.
+	 */
+	class LineScanner {
+		const char* p;
+		const char* end;
+
+		void skipSpaces() {
+			while (p != end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f'))
+				p++;
+		}
+		static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+	public:
+		LineScanner(const char* begin, const char* end) : p(begin), end(end) {}
+
+		bool expect(char c) {
+			skipSpaces();
+			if (p == end || *p != c)
+				return false;
+			p++;
+			return true;
+		}
+
+		bool readInt(int& value) {
+			skipSpaces();
+			bool negative = false;
+			if (p != end && (*p == '-' || *p == '+'))
+				negative = *p++ == '-';
+			if (p == end || !isDigit(*p))
+				return false;
+			long long n = 0, limit = negative ? -(long long)INT_MIN : INT_MAX;
+			while (p != end && isDigit(*p)) {
+				n = n * 10 + (*p++ - '0');
+				if (n > limit)
+					return false;	// out of the range of int: rejected like any other malformed number
+			}
+			value = (int)(negative ? -n : n);
+			return true;
+		}
+
+		/**
+		 * Decimal numbers whose digits fit in 53 bits, with a small exponent, are computed exactly from their digits
+		 * (the mantissa and the power of ten are both exact doubles, so the single multiplication or division is
+		 * correctly rounded). Anything else is handed to strtod, so the result is always the same as sscanf's.
+		 */
+		bool readDouble(double& value) {
+			skipSpaces();
+			bool negative = false;
+			if (p != end && (*p == '-' || *p == '+'))
+				negative = *p++ == '-';
+			const char* start = p;
+
+			unsigned long long mantissa = 0;
+			int digits = 0, exponent = 0;
+			bool truncated = false;
+			for (; p != end && isDigit(*p); p++, digits++) {
+				if (mantissa < 100000000000000000ULL)
+					mantissa = mantissa * 10 + (*p - '0');
+				else {
+					truncated = true;
+					exponent++;
+				}
+			}
+			if (p != end && *p == '.') {
+				p++;
+				for (; p != end && isDigit(*p); p++, digits++) {
+					if (mantissa < 100000000000000000ULL) {
+						mantissa = mantissa * 10 + (*p - '0');
+						exponent--;
+					}
+					else truncated = true;
+				}
+			}
+			if (digits == 0)
+				return false;
+			if (p != end && (*p == 'e' || *p == 'E')) {
+				const char* q = p + 1;
+				bool negativeExponent = false;
+				if (q != end && (*q == '-' || *q == '+'))
+					negativeExponent = *q++ == '-';
+				if (q != end && isDigit(*q)) {
+					int e = 0;
+					while (q != end && isDigit(*q)) {
+						if (e < 100000)
+							e = e * 10 + (*q - '0');
+						q++;
+					}
+					exponent += negativeExponent ? -e : e;
+					p = q;
+				}
+			}
+
+			if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+				double d = (double)mantissa;
+				d = exponent < 0 ? d / EXACT_POWERS_OF_10[-exponent] : d * EXACT_POWERS_OF_10[exponent];
+				value = negative ? -d : d;
+				return true;
+			}
+
+			string number(start, p);	// strtod needs the number NUL-terminated
+			double d = strtod(number.c_str(), NULL);
+			value = negative ? -d : d;
+			return true;
+		}
+	};
+
+	// Calls parseLine(begin, end) for every line in [begin, end), without the '\n'
+	template <class LineParser>
+	void forEachLine(const char* begin, const char* end, LineParser parseLine) {
+		while (begin < end) {
+			const char* lineEnd = (const char*)memchr(begin, '\n', end - begin);
+			if (lineEnd == NULL)
+				lineEnd = end;
+			parseLine(begin, lineEnd);
+			begin = lineEnd + 1;
+		}
+	}
+}
+
+void graphfile::parseNodes(const char* begin, const char* end, vector<VertexRecord>& vertices) {
+	forEachLine(begin, end, [&](const char* lineBegin, const char* lineEnd) {
+		LineScanner scanner(lineBegin, lineEnd);
+		VertexRecord v;
+		if (scanner.expect('(') && scanner.readInt(v.ID) && scanner.expect(',')
+			&& scanner.readDouble(v.x) && scanner.expect(',') && scanner.readDouble(v.y))
+			vertices.push_back(v);
+	});
+}
+
+void graphfile::parseEdges(const char* begin, const char* end, vector<EdgeIDRecord>& edges) {
+	forEachLine(begin, end, [&](const char* lineBegin, const char* lineEnd) {
+		LineScanner scanner(lineBegin, lineEnd);
+		EdgeIDRecord e;
+		if (scanner.expect('(') && scanner.readInt(e.srcID) && scanner.expect(',') && scanner.readInt(e.destID))
+			edges.push_back(e);
+	});
+}
+
+vector<const char*> graphfile::splitLines(const char* begin, const char* end, size_t numChunks) {
+	vector<const char*> bounds(1, begin);
+	for (size_t i = 1; i < numChunks; i++) {
+		const char* p = begin + (end - begin) * i / numChunks;
+		if (p <= bounds.back())
+			continue;
+		const char* lineEnd = (const char*)memchr(p - 1, '\n', end - (p - 1));	// a chunk may start right after a '\n'
+		if (lineEnd == NULL)
+			break;
+		if (lineEnd + 1 > bounds.back() && lineEnd + 1 < end)
+			bounds.push_back(lineEnd + 1);
+	}
+	bounds.push_back(end);
+	return bounds;
+}
+
+bool graphfile::parseTags(const char* begin, const char* end, vector<TagRecord>& tags) {
+	// Non empty lines, without surrounding whitespace
+	vector<pair<const char*, const char*>> lines;
+	forEachLine(begin, end, [&](const char* lineBegin, const char* lineEnd) {
+		while (lineBegin != lineEnd && isspace((unsigned char)*lineBegin))
+			lineBegin++;
+		while (lineEnd != lineBegin && isspace((unsigned char)lineEnd[-1]))
+			lineEnd--;
+		if (lineBegin != lineEnd)
+			lines.push_back(make_pair(lineBegin, lineEnd));
+	});
+
+	size_t next = 0;
+	auto readInt = [&](int& value) {
+		if (next == lines.size() || !LineScanner(lines[next].first, lines[next].second).readInt(value))
+			return false;
+		next++;
+		return true;
+	};
+
+	int numTags;
+	if (!readInt(numTags) || numTags < 0)
+		return false;
+	for (int t = 0; t < numTags; t++) {
+		if (next == lines.size())
+			return false;
+		TagRecord tag;
+		tag.name.assign(lines[next].first, lines[next].second);
+		next++;
+		int count;
+		if (!readInt(count) || count < 0 || lines.size() - next < (size_t)count)
+			return false;
+		tag.ids.resize(count);
+		for (int i = 0; i < count; i++) {
+			if (!readInt(tag.ids[i]))
+				return false;
+		}
+		tags.push_back(move(tag));
+	}
+	return true;
+}
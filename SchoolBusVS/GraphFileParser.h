@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include "Graph.h"
+
+using namespace std;
+
+// Endpoints of an edge of the edge file, as vertex IDs
+struct EdgeIDRecord {
+	int srcID, destID;
+};
+
+// A tag of the tag file and the IDs of its vertices, in file order
+struct TagRecord {
+	string name;
+	vector<int> ids;
+};
+
+/**
+ * Parsers of the text graph files, working in place on a range of characters (usually a MappedFile).
+ * Node lines are "(ID, x, y)" and edge lines "(srcID, destID)". Lines that don't hold such a tuple,
+ * like the count in the first line of the T05_* files, are skipped.
+ */
+namespace graphfile {
+	/**
+	 * Appends the vertex of every node line in [begin, end) to vertices.
+	 */
+	void parseNodes(const char* begin, const char* end, vector<VertexRecord>& vertices);
+
+	/**
+	 * Appends the endpoints of every edge line in [begin, end) to edges.
+	 */
+	void parseEdges(const char* begin, const char* end, vector<EdgeIDRecord>& edges);
+
+	/**
+	 * Splits [begin, end) into at most numChunks ranges of whole lines, of about the same size.
+	 * Returns the boundaries: chunk i is [bounds[i], bounds[i + 1]).
+	 */
+	vector<const char*> splitLines(const char* begin, const char* end, size_t numChunks);
+
+	/**
+	 * Parses a T05_tags file: the number of tags, then for each tag its name ("amenity=school"), the number
+	 * of its vertices and their IDs, one value per line. Returns false if the file ends early or a count isn't a number.
+	 */
+	bool parseTags(const char* begin, const char* end, vector<TagRecord>& tags);
+}
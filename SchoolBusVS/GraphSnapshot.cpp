@@ -0,0 +1,133 @@
+#include "GraphSnapshot.h"
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+
+static const char MAGIC[8] = "SBGRAPH";
+
+// The builders give the two directions of each edge line their own ID, so even after dropping parallel edges
+// the IDs stay within a small multiple of the number of edges. A larger one comes from a damaged file.
+static const size_t MAX_EDGE_IDS_PER_EDGE = 4;
+
+// Whether the CSR arrays are consistent: offsets never decrease and end at numEdges, every target is a vertex,
+// and every edge ID is -1 (none) or small enough to index edgesByID
+static bool validCSR(const unsigned* offsets, const unsigned* targets, const int* edgeIDs, size_t numVertices, size_t numEdges) {
+	if (offsets[0] != 0 || offsets[numVertices] != numEdges)
+		return false;
+	for (size_t v = 0; v < numVertices; v++) {
+		if (offsets[v] > offsets[v + 1])
+			return false;
+	}
+	size_t maxEdgeID = MAX_EDGE_IDS_PER_EDGE * numEdges;
+	for (size_t e = 0; e < numEdges; e++) {
+		if (targets[e] >= numVertices || edgeIDs[e] < -1 || (edgeIDs[e] >= 0 && (size_t)edgeIDs[e] > maxEdgeID))
+			return false;
+	}
+	return true;
+}
+
+GraphSnapshot::GraphSnapshot(const string& path) : file(path) {
+	if (!file.isOpen() || file.size() < sizeof(Header))
+		return;
+	const Header* h = (const Header*)file.begin();
+	if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->version != VERSION || h->byteOrder != BYTE_ORDER_MARK)
+		return;
+
+	if (h->numVertices > file.size() || h->numEdges > file.size())	// so the expected size can't overflow
+		return;
+	size_t numVertices = (size_t)h->numVertices, numEdges = (size_t)h->numEdges;
+	size_t expectedSize = sizeof(Header) + sectionSize(numVertices, sizeof(int)) + 2 * sectionSize(numVertices, sizeof(double))
+		+ sectionSize(numVertices + 1, sizeof(unsigned)) + sectionSize(numEdges, sizeof(unsigned))
+		+ sectionSize(numEdges, sizeof(double)) + sectionSize(numEdges, sizeof(int));
+	if (h->flags & GEO_COORDINATES)
+		expectedSize += 2 * sectionSize(numVertices, sizeof(int));
+	if (file.size() != expectedSize)
+		return;
+
+	const char* p = file.begin() + sizeof(Header);
+	ids = (const int*)p;			p += sectionSize(numVertices, sizeof(int));
+	xs = (const double*)p;			p += sectionSize(numVertices, sizeof(double));
+	ys = (const double*)p;			p += sectionSize(numVertices, sizeof(double));
+	offsets = (const unsigned*)p;	p += sectionSize(numVertices + 1, sizeof(unsigned));
+	targets = (const unsigned*)p;	p += sectionSize(numEdges, sizeof(unsigned));
+	weights = (const double*)p;		p += sectionSize(numEdges, sizeof(double));
+	edgeIDs = (const int*)p;		p += sectionSize(numEdges, sizeof(int));
+	if (h->flags & GEO_COORDINATES) {
+		latsE7 = (const int*)p;		p += sectionSize(numVertices, sizeof(int));
+		lonsE7 = (const int*)p;
+	}
+	if (!validCSR(offsets, targets, edgeIDs, numVertices, numEdges))
+		return;
+	header = h;
+}
+
+// Writes count elements followed by the padding of their section
+template <class T>
+static void writeSection(ofstream& out, const T* data, size_t count) {
+	static const char zeros[8] = {};
+	out.write((const char*)data, count * sizeof(T));
+	out.write(zeros, GraphSnapshot::sectionSize(count, sizeof(T)) - count * sizeof(T));
+}
+
+GraphSnapshot::Header GraphSnapshot::makeHeader(size_t numVertices, size_t numEdges, unsigned long long sourceKey, unsigned long long flags) {
+	Header h;
+	memcpy(h.magic, MAGIC, sizeof(MAGIC));
+	h.version = VERSION;
+	h.byteOrder = BYTE_ORDER_MARK;
+	h.sourceKey = sourceKey;
+	h.numVertices = numVertices;
+	h.numEdges = numEdges;
+	h.flags = flags;
+	return h;
+}
+
+bool GraphSnapshot::write(const Graph& graph, const string& path, unsigned long long sourceKey) {
+	size_t numVertices = graph.getNumVertex();
+	const vector<unsigned>& offsets = graph.getCSROffsets();
+	if (offsets.size() != numVertices + 1)
+		return false;
+
+	Header h = makeHeader(numVertices, graph.getCSRTargets().size(), sourceKey, graph.hasGeoCoordinates() ? GEO_COORDINATES : 0);
+
+	vector<int> ids(numVertices);
+	for (size_t i = 0; i < numVertices; i++)
+		ids[i] = graph.getVertexSet()[i]->getID();
+
+	// Written next to the destination first, so a reader never maps a half written snapshot
+	string tmpPath = path + ".tmp";
+	{
+		ofstream out(tmpPath, ios::binary | ios::trunc);
+		if (!out)
+			return false;
+		out.write((const char*)&h, sizeof(Header));
+		writeSection(out, ids.data(), numVertices);
+		writeSection(out, graph.getXs().data(), numVertices);
+		writeSection(out, graph.getYs().data(), numVertices);
+		writeSection(out, offsets.data(), offsets.size());
+		writeSection(out, graph.getCSRTargets().data(), graph.getCSRTargets().size());
+		writeSection(out, graph.getCSRWeights().data(), graph.getCSRWeights().size());
+		writeSection(out, graph.getCSREdgeIDs().data(), graph.getCSREdgeIDs().size());
+		if (h.flags & GEO_COORDINATES) {
+			writeSection(out, graph.getLatsE7().data(), numVertices);
+			writeSection(out, graph.getLonsE7().data(), numVertices);
+		}
+		if (!out.flush()) {
+			out.close();
+			remove(tmpPath.c_str());
+			return false;
+		}
+	}
+	remove(path.c_str());
+	return rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+unique_ptr<Graph> GraphSnapshot::toGraph() const {
+	unique_ptr<Graph> graph(new Graph);
+	if (!isValid())
+		return graph;
+	if (!graph->addCSR(getNumVertex(), ids, xs, ys, offsets, targets, weights, edgeIDs))
+		return unique_ptr<Graph>(new Graph);	// repeated vertex IDs: a damaged file
+	if (hasGeoCoordinates())
+		graph->setGeoCoordinates(vector<int>(latsE7, latsE7 + getNumVertex()), vector<int>(lonsE7, lonsE7 + getNumVertex()));
+	return graph;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <memory>
+#include "Graph.h"
+#include "MappedFile.h"
+
+/**
+ * Binary image of a finalized Graph: a header followed by the vertex IDs, the coordinate arrays and the CSR arrays
+ * (then the latitudes and longitudes, if the graph has them), each one starting at a multiple of 8 bytes. Opening a
+ * snapshot maps the file and points straight into it, so the searches in SearchAlgorithms.h can run on the mapping
+ * without reading it first.
+ *
+ * toGraph() is not zero-copy: it skips parsing and sorting, but still creates every Vertex and Edge and fills the ID
+ * and edge indexes one element at a time (on the whole of Portugal, ~33 ms against ~0.1 ms to map the file).
+ * GraphBuilder::build() and so the application always go through toGraph(), so their startup is not dominated by
+ * page faults: only code that searches the snapshot itself avoids the per element work.
+ */
+class GraphSnapshot {
+public:
+	static const unsigned VERSION = 2;
+	static const unsigned long long GEO_COORDINATES = 1;	// flag: the lat/lon sections follow the edge IDs
+
+	struct Header {
+		char magic[8];					// "SBGRAPH"
+		unsigned version;
+		unsigned byteOrder;				// BYTE_ORDER_MARK as written, to reject files from other architectures
+		unsigned long long sourceKey;	// identifies what the snapshot was made from (see GraphBuilder)
+		unsigned long long numVertices;
+		unsigned long long numEdges;
+		unsigned long long flags;
+	};
+
+	// Header of a snapshot with the given sizes
+	static Header makeHeader(size_t numVertices, size_t numEdges, unsigned long long sourceKey, unsigned long long flags = 0);
+	// Size in the file of a section of count elements, padded so that the next one stays aligned
+	static size_t sectionSize(size_t count, size_t elementSize) { return (count * elementSize + 7) / 8 * 8; }
+private:
+	static const unsigned BYTE_ORDER_MARK = 0x01020304;
+
+	MappedFile file;
+	const Header* header = NULL;
+	const int* ids = NULL;
+	const double* xs = NULL;
+	const double* ys = NULL;
+	const unsigned* offsets = NULL;
+	const unsigned* targets = NULL;
+	const double* weights = NULL;
+	const int* edgeIDs = NULL;
+	const int* latsE7 = NULL;
+	const int* lonsE7 = NULL;
+public:
+	/**
+	 * Maps the snapshot at path. If it's missing, truncated, of another version, or its CSR arrays are inconsistent
+	 * (offsets out of order, targets that aren't vertices, out of range edge IDs), isValid() is false.
+	 */
+	GraphSnapshot(const string& path);
+
+	/**
+	 * Writes the snapshot of a graph (which must be finalized) to path, replacing it only once complete.
+	 * Returns false if the file couldn't be written.
+	 */
+	static bool write(const Graph& graph, const string& path, unsigned long long sourceKey);
+
+	bool isValid() const { return header != NULL; }
+	unsigned long long getSourceKey() const { return header->sourceKey; }
+	size_t getNumVertex() const { return (size_t)header->numVertices; }
+	size_t getNumEdges() const { return (size_t)header->numEdges; }
+	int getID(unsigned index) const { return ids[index]; }
+	const double* getXs() const { return xs; }
+	const double* getYs() const { return ys; }
+	bool hasGeoCoordinates() const { return latsE7 != NULL; }
+	const int* getLatsE7() const { return latsE7; }
+	const int* getLonsE7() const { return lonsE7; }
+
+	/**
+	 * Calls visit(dest, weight) for every outgoing edge of vertex v (dense indexes).
+	 */
+	template <class Visitor>
+	void forEachEdge(unsigned v, Visitor visit) const {
+		for (unsigned e = offsets[v]; e < offsets[v + 1]; e++)
+			visit(targets[e], weights[e]);
+	}
+
+	/**
+	 * Graph with the contents of the snapshot, built element by element from the mapped arrays (see the class comment).
+	 * Empty if the snapshot isn't valid or repeats a vertex ID.
+	 */
+	unique_ptr<Graph> toGraph() const;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * Mutable priority queue of dense vertex indexes, with the same 1-based binary heap as MutablePriorityQueue.
+ * Keys and heap positions are not stored in the elements but in external arrays (usually owned by a SearchContext),
+ * so several queues can work on the same graph at once.
+ *
+ * @tparam Weight Type of the keys
+ */
+template <class Weight>
+class IndexedPriorityQueue {
+	vector<unsigned> H;
+	const vector<Weight>& key;
+	vector<unsigned>& queueIndex;	// position of each element in H, 0 if not in the queue
+	void heapifyUp(unsigned i);
+	void heapifyDown(unsigned i);
+	void set(unsigned i, unsigned x) {
+		H[i] = x;
+		queueIndex[x] = i;
+	}
+public:
+	static constexpr bool supportsDecreaseKey = true;
+
+	IndexedPriorityQueue(const vector<Weight>& key, vector<unsigned>& queueIndex);
+	void insert(unsigned x);
+	unsigned extractMin();
+	void decreaseKey(unsigned x);
+	bool empty() const { return H.size() == 1; }
+};
+
+template <class Weight>
+IndexedPriorityQueue<Weight>::IndexedPriorityQueue(const vector<Weight>& key, vector<unsigned>& queueIndex) : key(key), queueIndex(queueIndex) {
+	H.push_back(0);
+	// indices will be used starting in 1
+	// to facilitate parent/child calculations
+}
+
+template <class Weight>
+unsigned IndexedPriorityQueue<Weight>::extractMin() {
+	unsigned x = H[1];
+	queueIndex[x] = 0;
+	H[1] = H.back();
+	H.pop_back();
+	if (!empty())
+		heapifyDown(1);
+	return x;
+}
+
+template <class Weight>
+void IndexedPriorityQueue<Weight>::insert(unsigned x) {
+	H.push_back(x);
+	heapifyUp((unsigned)H.size() - 1);
+}
+
+template <class Weight>
+void IndexedPriorityQueue<Weight>::decreaseKey(unsigned x) {
+	heapifyUp(queueIndex[x]);
+}
+
+template <class Weight>
+void IndexedPriorityQueue<Weight>::heapifyUp(unsigned i) {
+	unsigned x = H[i];
+	while (i > 1 && key[x] < key[H[i >> 1]]) {
+		set(i, H[i >> 1]);
+		i = i >> 1;
+	}
+	set(i, x);
+}
+
+template <class Weight>
+void IndexedPriorityQueue<Weight>::heapifyDown(unsigned i) {
+	unsigned x = H[i];
+	while (true) {
+		unsigned k = i << 1;
+		if (k >= H.size())
+			break;
+		if (k + 1 < H.size() && key[H[k + 1]] < key[H[k]])
+			k++; // right child of i
+		if (!(key[H[k]] < key[x]))
+			break;
+		set(i, H[k]);
+		i = k;
+	}
+	set(i, x);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <functional>
+
+using namespace std;
+
+/**
+ * Priority queue of dense vertex indexes without decrease-key: a lower key is pushed as a new entry
+ * and the outdated entries are skipped when they reach the top. Same interface as IndexedPriorityQueue.
+ *
+ * @tparam Weight Type of the keys
+ */
+template <class Weight>
+class LazyPriorityQueue {
+	typedef pair<Weight, unsigned> Entry;
+	priority_queue<Entry, vector<Entry>, greater<Entry>> H;
+	const vector<Weight>& key;
+	void skipOutdated() {
+		while (!H.empty() && H.top().first != key[H.top().second])
+			H.pop();
+	}
+public:
+	static constexpr bool supportsDecreaseKey = false;
+
+	LazyPriorityQueue(const vector<Weight>& key, vector<unsigned>&) : key(key) {}
+	void insert(unsigned x) { H.push(Entry(key[x], x)); }
+	unsigned extractMin() {
+		skipOutdated();
+		unsigned x = H.top().second;
+		H.pop();
+		return x;
+	}
+	bool empty() {
+		skipOutdated();
+		return H.empty();
+	}
+};
@@ -0,0 +1,87 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const string& path) {
+	HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (f == INVALID_HANDLE_VALUE)
+		return;
+	file = f;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(f, &fileSize)) {
+		close();
+		return;
+	}
+	length = (size_t)fileSize.QuadPart;
+	open = true;
+	if (length == 0)	// empty files can't be mapped
+		return;
+	mapping = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping != NULL)
+		data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == NULL)
+		close();
+}
+
+void MappedFile::close() {
+	if (data != NULL)
+		UnmapViewOfFile(data);
+	if (mapping != NULL)
+		CloseHandle(mapping);
+	if (file != NULL)
+		CloseHandle(file);
+	data = NULL;
+	mapping = file = NULL;
+	length = 0;
+	open = false;
+}
+
+#else
+
+MappedFile::MappedFile(const string& path) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return;
+	struct stat st;
+	if (fstat(fd, &st) == 0) {
+		length = (size_t)st.st_size;
+		open = true;
+		if (length > 0) {
+			void* p = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (p != MAP_FAILED) {
+				data = (const char*)p;
+				madvise(p, length, MADV_SEQUENTIAL);
+			}
+			else {
+				length = 0;
+				open = false;
+			}
+		}
+	}
+	::close(fd);	// the mapping stays valid after closing the descriptor
+}
+
+void MappedFile::close() {
+	if (data != NULL)
+		munmap((void*)data, length);
+	data = NULL;
+	length = 0;
+	open = false;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+	close();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * Read-only memory mapping of a whole file. The contents are paged in by the OS on first access,
+ * so the file can be parsed in place without copying it into a buffer.
+ */
+class MappedFile {
+	const char* data = NULL;
+	size_t length = 0;
+	bool open = false;
+#ifdef _WIN32
+	void* file = NULL;
+	void* mapping = NULL;
+#endif
+	void close();
+public:
+	MappedFile(const string& path);
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool isOpen() const { return open; }
+	size_t size() const { return length; }
+	const char* begin() const { return data; }
+	const char* end() const { return data + length; }
+};
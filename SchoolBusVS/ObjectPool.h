@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <new>
+#include <utility>
+
+using namespace std;
+
+/**
+ * Arena for objects of a single type.
+ * Objects are constructed inside a few large blocks and are only destroyed (all at once) with the pool,
+ * so their addresses stay valid for the pool's whole lifetime.
+ */
+template <class T>
+class ObjectPool {
+	struct Block {
+		T* data;
+		size_t used;
+		size_t capacity;
+	};
+	vector<Block> blocks;
+	size_t count = 0;
+	size_t nextBlockSize = 256;
+	void addBlock(size_t capacity);
+public:
+	ObjectPool() {}
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+	~ObjectPool() { clear(); }
+
+	template <class... Args>
+	T* create(Args&&... args);
+	void reserve(size_t n);		// makes sure the next n objects fit in the current block
+	void clear();
+	size_t size() const { return count; }
+	size_t memoryUsage() const;
+};
+
+template <class T>
+void ObjectPool<T>::addBlock(size_t capacity) {
+	Block block;
+	block.data = static_cast<T*>(::operator new(capacity * sizeof(T)));
+	block.used = 0;
+	block.capacity = capacity;
+	blocks.push_back(block);
+}
+
+template <class T>
+template <class... Args>
+T* ObjectPool<T>::create(Args&&... args) {
+	if (blocks.empty() || blocks.back().used == blocks.back().capacity) {
+		addBlock(nextBlockSize);
+		nextBlockSize *= 2;
+	}
+	Block& block = blocks.back();
+	T* obj = new (block.data + block.used) T(std::forward<Args>(args)...);
+	block.used++;
+	count++;
+	return obj;
+}
+
+template <class T>
+void ObjectPool<T>::reserve(size_t n) {
+	if (!blocks.empty() && blocks.back().capacity - blocks.back().used >= n)
+		return;
+	addBlock(n > nextBlockSize ? n : nextBlockSize);
+}
+
+template <class T>
+size_t ObjectPool<T>::memoryUsage() const {
+	size_t bytes = blocks.capacity() * sizeof(Block);
+	for (const Block& block : blocks)
+		bytes += block.capacity * sizeof(T);
+	return bytes;
+}
+
+template <class T>
+void ObjectPool<T>::clear() {
+	for (Block& block : blocks) {
+		for (size_t i = 0; i < block.used; i++)
+			block.data[i].~T();
+		::operator delete(block.data);
+	}
+	blocks.clear();
+	count = 0;
+}
@@ -0,0 +1,138 @@
+#include "OneToAllSweep.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SWEEP_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SWEEP_SSE2
+#endif
+
+OneToAllSweep::OneToAllSweep(const ContractionHierarchy& hierarchy) : hierarchy(&hierarchy) {
+	const vector<unsigned>& offsets = hierarchy.getBackwardOffsets();
+	const vector<ContractionHierarchy::Arc>& arcs = hierarchy.getBackwardArcs();
+	size_t numVertices = offsets.empty() ? 0 : offsets.size() - 1;
+	order.resize(numVertices);
+	position.resize(numVertices);
+	for (unsigned v = 0; v < numVertices; v++) {
+		position[v] = (unsigned)numVertices - 1 - hierarchy.getRank(v);
+		order[position[v]] = v;
+	}
+
+	// The arcs into each vertex from higher ranked ones, sorted by where they come from in the scan
+	downOffsets.assign(numVertices + 1, 0);
+	downArcs.reserve(arcs.size());
+	for (unsigned i = 0; i < numVertices; i++) {
+		unsigned v = order[i];
+		for (unsigned a = offsets[v]; a < offsets[v + 1]; a++)
+			downArcs.push_back({ arcs[a].weight, position[arcs[a].vertex] });
+		sort(downArcs.begin() + downOffsets[i], downArcs.end(), [](const DownArc& a, const DownArc& b) { return a.from < b.from; });
+		downOffsets[i + 1] = (unsigned)downArcs.size();
+	}
+}
+
+// Upward search from source, writing the distances of the vertices it settles to dist (by scan position, every stride)
+void OneToAllSweep::upward(unsigned source, SearchContext& context, vector<unsigned>& settled, double* dist, unsigned stride) const {
+	hierarchy->upwardSearch(source, true, context, settled);
+	for (unsigned v : settled)
+		dist[(size_t)position[v] * stride] = context.dist[v];
+}
+
+// Scan of one row of distances, by scan position
+void OneToAllSweep::sweep(double* dist) const {
+	for (size_t i = 0; i < order.size(); i++) {
+		double d = dist[i];
+		for (unsigned a = downOffsets[i]; a < downOffsets[i + 1]; a++)
+			d = min(d, dist[downArcs[a].from] + downArcs[a].weight);
+		dist[i] = d;
+	}
+}
+
+// Scan of SWEEP_WIDTH rows of distances interleaved by scan position (dist[i * SWEEP_WIDTH + row])
+void OneToAllSweep::sweepMany(double* dist) const {
+	for (size_t i = 0; i < order.size(); i++) {
+		double* d = dist + i * SWEEP_WIDTH;
+#if defined(SWEEP_AVX2)
+		__m256d low = _mm256_loadu_pd(d), high = _mm256_loadu_pd(d + 4);
+		for (unsigned a = downOffsets[i]; a < downOffsets[i + 1]; a++) {
+			const double* from = dist + (size_t)downArcs[a].from * SWEEP_WIDTH;
+			__m256d weight = _mm256_set1_pd(downArcs[a].weight);
+			low = _mm256_min_pd(low, _mm256_add_pd(_mm256_loadu_pd(from), weight));
+			high = _mm256_min_pd(high, _mm256_add_pd(_mm256_loadu_pd(from + 4), weight));
+		}
+		_mm256_storeu_pd(d, low);
+		_mm256_storeu_pd(d + 4, high);
+#elif defined(SWEEP_SSE2)
+		__m128d lanes[SWEEP_WIDTH / 2];
+		for (unsigned l = 0; l < SWEEP_WIDTH / 2; l++)
+			lanes[l] = _mm_loadu_pd(d + 2 * l);
+		for (unsigned a = downOffsets[i]; a < downOffsets[i + 1]; a++) {
+			const double* from = dist + (size_t)downArcs[a].from * SWEEP_WIDTH;
+			__m128d weight = _mm_set1_pd(downArcs[a].weight);
+			for (unsigned l = 0; l < SWEEP_WIDTH / 2; l++)
+				lanes[l] = _mm_min_pd(lanes[l], _mm_add_pd(_mm_loadu_pd(from + 2 * l), weight));
+		}
+		for (unsigned l = 0; l < SWEEP_WIDTH / 2; l++)
+			_mm_storeu_pd(d + 2 * l, lanes[l]);
+#else
+		for (unsigned a = downOffsets[i]; a < downOffsets[i + 1]; a++) {
+			const double* from = dist + (size_t)downArcs[a].from * SWEEP_WIDTH;
+			for (unsigned l = 0; l < SWEEP_WIDTH; l++)
+				d[l] = min(d[l], from[l] + downArcs[a].weight);
+		}
+#endif
+	}
+}
+
+vector<double> OneToAllSweep::distancesFrom(unsigned source) const {
+	vector<double> scanned(order.size(), INF);
+	SearchContext context;
+	vector<unsigned> settled;
+	upward(source, context, settled, scanned.data(), 1);
+	sweep(scanned.data());
+
+	vector<double> dist(order.size());
+	for (size_t v = 0; v < order.size(); v++)
+		dist[v] = scanned[position[v]];
+	return dist;
+}
+
+vector<double> OneToAllSweep::distanceRows(const vector<unsigned>& sources, unsigned numThreads) const {
+	size_t numVertices = order.size();
+	vector<double> rows(sources.size() * numVertices);
+	size_t numBatches = (sources.size() + SWEEP_WIDTH - 1) / SWEEP_WIDTH;
+	numThreads = (unsigned)max<size_t>(min<size_t>(numThreads, numBatches), 1);
+
+	// Each chunk sweeps every numThreads-th batch with its own buffers
+	auto sweepBatches = [&](size_t chunk) {
+		vector<double> scanned(numVertices * SWEEP_WIDTH);
+		SearchContext context;
+		vector<unsigned> settled;
+		for (size_t batch = chunk; batch < numBatches; batch += numThreads) {
+			size_t first = batch * SWEEP_WIDTH;
+			size_t width = min<size_t>(SWEEP_WIDTH, sources.size() - first);
+			fill(scanned.begin(), scanned.end(), INF);
+			for (size_t row = 0; row < width; row++)
+				upward(sources[first + row], context, settled, scanned.data() + row, SWEEP_WIDTH);
+			sweepMany(scanned.data());
+			for (size_t v = 0; v < numVertices; v++) {
+				const double* d = &scanned[(size_t)position[v] * SWEEP_WIDTH];
+				for (size_t row = 0; row < width; row++)
+					rows[(first + row) * numVertices + v] = d[row];
+			}
+		}
+	};
+	unique_ptr<ThreadPool> pool;
+	if (numThreads > 1)
+		pool.reset(new ThreadPool(numThreads));
+	forEachChunk(pool.get(), numThreads, sweepBatches);
+	return rows;
+}
+
+size_t OneToAllSweep::getMemoryUsage() const {
+	return sizeof(OneToAllSweep) + (order.capacity() + position.capacity() + downOffsets.capacity()) * sizeof(unsigned)
+		+ downArcs.capacity() * sizeof(DownArc);
+}
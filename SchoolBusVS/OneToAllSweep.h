@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include "ContractionHierarchy.h"
+
+using namespace std;
+
+/**
+ * Distances from a vertex to every vertex over a ContractionHierarchy (PHAST): an upward search from the source,
+ * then one linear scan of the vertices from the highest ranked down, each taking the shortest of its arcs from the
+ * higher ranked vertices already scanned. The vertices and their downward arcs are renumbered in scan order, so
+ * the scan reads the arcs sequentially and the distances mostly from nearby positions.
+ *
+ * Several sources are swept together, SWEEP_WIDTH at a time: their distances to a vertex are stored side by side
+ * and relaxed with AVX2 or SSE2 when the compiler targets them, which spreads the scan over all the rows.
+ *
+ * The sweep refers to the hierarchy (and its graph), so it must not outlive it.
+ */
+class OneToAllSweep {
+public:
+	// Sources swept together by distanceRows (8 doubles: a cache line per vertex)
+	static const unsigned SWEEP_WIDTH = 8;
+
+	// Arc into a vertex from a higher ranked one, by scan position
+	struct DownArc {
+		double weight;
+		unsigned from;
+	};
+private:
+	const ContractionHierarchy* hierarchy;
+	vector<unsigned> order;		// scan position -> dense index, highest rank first
+	vector<unsigned> position;	// dense index -> scan position
+	vector<unsigned> downOffsets;
+	vector<DownArc> downArcs;
+
+	void upward(unsigned source, SearchContext& context, vector<unsigned>& settled, double* dist, unsigned stride) const;
+	void sweep(double* dist) const;
+	void sweepMany(double* dist) const;
+public:
+	/**
+	 * Scan order and downward arcs of hierarchy, which must be built.
+	 */
+	OneToAllSweep(const ContractionHierarchy& hierarchy);
+
+	/**
+	 * Distances from source (dense index) to every vertex, by dense index, INF where there's no path.
+	 */
+	vector<double> distancesFrom(unsigned source) const;
+
+	/**
+	 * Distances from every source to every vertex, row by row (sources.size() rows of getNumVertex() distances,
+	 * by dense index), INF where there's no path. The batches of SWEEP_WIDTH sources run on numThreads threads.
+	 */
+	vector<double> distanceRows(const vector<unsigned>& sources, unsigned numThreads = 1) const;
+
+	size_t getMemoryUsage() const;	// approximate heap usage, in bytes
+};
@@ -4,8 +4,17 @@ double PathMatrix::getDist(int srcID, int destID) {
 	return distances[srcID][destID];
 }
 
-vector<Vertex*> PathMatrix::getPath(int srcID, int destID) {
-	return paths[srcID][destID];
+const vector<Vertex*>& PathMatrix::getPath(int srcID, int destID) {
+	unordered_map<int, vector<Vertex*>>& row = paths[srcID];
+	auto path = row.find(destID);
+	if (path == row.end()) {
+		vector<Vertex*> computed;
+		auto distRow = distances.find(srcID);
+		if (pathSource && distRow != distances.end() && distRow->second.count(destID) > 0 && distRow->second.at(destID) != INF)
+			computed = pathSource(srcID, destID);
+		path = row.emplace(destID, move(computed)).first;
+	}
+	return path->second;
 }
 
 void PathMatrix::setPath(int srcID, int destID, double dist, const vector<Vertex*>& path) {
@@ -13,6 +22,14 @@ void PathMatrix::setPath(int srcID, int destID, double dist, const vector<Vertex
 	distances[srcID][destID] = dist;
 }
 
+void PathMatrix::setDist(int srcID, int destID, double dist) {
+	distances[srcID][destID] = dist;
+}
+
+void PathMatrix::setPathSource(function<vector<Vertex*>(int, int)> source) {
+	pathSource = source;
+}
+
 int PathMatrix::getNumMissingPaths(const vector<int>& ids, bool enableLog)
 {
 	int missingPaths = 0;
@@ -29,5 +46,3 @@ int PathMatrix::getNumMissingPaths(const vector<int>& ids, bool enableLog)
 	return missingPaths;
 
 }
-
-
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <functional>
 
 #include "Graph.h"
 
@@ -13,11 +14,19 @@ class PathMatrix
 {
 	unordered_map<int, unordered_map<int, vector<Vertex*>>> paths;
 	unordered_map<int, unordered_map<int, double>> distances;
+	function<vector<Vertex*>(int, int)> pathSource;	// computes the paths that weren't set (see setPathSource)
 public:
 	double getDist(int srcID, int destID);
-	vector<Vertex*> getPath(int srcID, int destID);
+	const vector<Vertex*>& getPath(int srcID, int destID);
 
 	void setPath(int srcID, int destID, double dist, const vector<Vertex*>& path);
+	void setDist(int srcID, int destID, double dist);	// the path is left to the path source
+
+	/**
+	 * Makes getPath compute (once) the path of a pair whose distance was set without it, with source(srcID, destID).
+	 * Copies of the matrix get copies of source. A matrix, like its maps, is meant for one thread at a time.
+	 */
+	void setPathSource(function<vector<Vertex*>(int, int)> source);
 
 	int getNumMissingPaths(const vector<int>& ids, bool enableLog);
 };
@@ -48,15 +48,21 @@ int POI::getID() const {
 
 
 bool PoIList::existsSchool(Vertex* school) const {
-	for (auto poi : this->pois) {
+	for (const POI& poi : this->pois) {
 		if (poi.getType() == POI::School && poi.getVertex()->getID() == school->getID())
 			return true;
 	}
 	return false;
 }
 
+void PoIList::addPoI(const POI& poi) {
+	pois.push_back(poi);
+	ids.push_back(poi.getID());
+	vertices.push_back(poi.getVertex());
+}
+
 PoIList::PoIList(Vertex * garage) : garage(garage) {
-	pois.push_back(POI(garage, POI::Garage));
+	addPoI(POI(garage, POI::Garage));
 }
 
 PoIList::PoIList(string fileName, const Graph* graph) {
@@ -65,20 +71,29 @@ PoIList::PoIList(string fileName, const Graph* graph) {
 	int garageID, homeID, schoolID;
 	f >> garageID;
 	this->garage = graph->findVertex(garageID);
-	pois.push_back(POI(this->garage, POI::Garage));
+	addPoI(POI(this->garage, POI::Garage));
 
 
 	while (f >> homeID && f >> schoolID) {
-		this->addHome(new Child(graph->findVertex(homeID), graph->findVertex(schoolID)));
+		this->addHome(graph->findVertex(homeID), graph->findVertex(schoolID));
 	}
 }
 
+vector<int> PoIList::readIDs(string fileName) {
+	ifstream f(fileName);
+	vector<int> ids;
+	int id;
+	while (f >> id)
+		ids.push_back(id);
+	return ids;
+}
+
 void PoIList::save(string fileName) {
 	ofstream f(fileName);
 
 	f << garage->getID() << endl;
 
-	for (POI poi : pois) {
+	for (const POI& poi : pois) {
 		if (poi.getType() == POI::Kid)
 			f << poi.getChild()->getHome()->getID() << " " << poi.getChild()->getSchool()->getID() << endl;
 	}
@@ -89,12 +104,7 @@ Vertex * PoIList::getGarage() const {
 	return garage;
 }
 
-vector<Child*> PoIList::getChildren() const {
-	vector<Child*> kids;
-	for (POI poi : pois) {
-		if (poi.getType() == POI::Kid)
-			kids.push_back(poi.getChild());
-	}
+const vector<Child*>& PoIList::getChildren() const {
 	return kids;
 }
 
@@ -102,35 +112,31 @@ void PoIList::changeGarage(Vertex * garage) {
 	for (size_t i = 0; i < pois.size(); i++) {
 		if (pois[i].getType() == POI::Garage) {
 			pois[i].garage = garage;
+			ids[i] = garage->getID();
+			vertices[i] = garage;
 			break;
 		}
 	}
 	this->garage = garage;
 }
 
-void PoIList::addHome(Child* child) {
-	pois.push_back(POI(child));
+void PoIList::addHome(Vertex* home, Vertex* school) {
+	children.push_back(make_shared<Child>(home, school));
+	Child* child = children.back().get();
+	kids.push_back(child);
+	addPoI(POI(child));
 	if (!existsSchool(child->getSchool()))
-		pois.push_back(POI(child->getSchool(), POI::School));
+		addPoI(POI(child->getSchool(), POI::School));
 }
 
-vector<int> PoIList::getIDs() const {
-	vector<int> list;
-
-	for (POI poi : pois) {
-		list.push_back(poi.getID());
-	}
-
-	return list;
+const vector<int>& PoIList::getIDs() const {
+	return ids;
 }
 
-vector<POI> PoIList::getPoIs() const {
+const vector<POI>& PoIList::getPoIs() const {
 	return pois;
 }
 
-vector<Vertex*> PoIList::getVertices() const {
-	vector<Vertex*> vertexList;
-	for (POI poi : pois)
-		vertexList.push_back(poi.getVertex());
-	return vertexList;
+const vector<Vertex*>& PoIList::getVertices() const {
+	return vertices;
 }
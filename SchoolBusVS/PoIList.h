@@ -1,6 +1,7 @@
 #pragma once
 
 #include <fstream>
+#include <memory>
 #include "Graph.h"
 #include "Child.h"
 
@@ -33,18 +34,25 @@ private:
 class PoIList
 {
 	vector<POI> pois;
+	vector<shared_ptr<Child>> children;	// owns the children referenced by pois (shared between copies of the list)
+	// Kept in step with pois, so the getters below don't build a new vector on every call
+	vector<Child*> kids;
+	vector<int> ids;
+	vector<Vertex*> vertices;
 	Vertex* garage;
 	bool existsSchool(Vertex* school) const;
+	void addPoI(const POI& poi);
 public:
 	PoIList(Vertex* garage);
 	PoIList(string fileName, const Graph* graph);
+	static vector<int> readIDs(string fileName);	// vertex IDs of the file (garage, homes and schools), without a graph
 	void save(string fileName);
 	Vertex* getGarage() const;
-	vector<Child*> getChildren() const;
+	const vector<Child*>& getChildren() const;
 	void changeGarage(Vertex* garage);
-	void addHome(Child* child);
-	vector<int> getIDs() const;
-	vector<POI> getPoIs() const;
-	vector<Vertex*> getVertices() const;
+	void addHome(Vertex* home, Vertex* school);
+	const vector<int>& getIDs() const;
+	const vector<POI>& getPoIs() const;
+	const vector<Vertex*>& getVertices() const;
 };
 
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <type_traits>
+#include "SearchContext.h"
+#include "IndexedPriorityQueue.h"
+#include "LazyPriorityQueue.h"
+
+using namespace std;
+
+/**
+ * Graph search kernels shared by Graph, CompactGraph and CSRGraph.
+ *
+ * An Adjacency type must provide getNumVertex() and forEachEdge(v, visit), which calls visit(dest, weight)
+ * for every outgoing edge of the dense vertex index v. The weight type of the adjacency is the Weight of
+ * the BasicSearchContext, and Queue is a priority queue policy (IndexedPriorityQueue or LazyPriorityQueue).
+ */
+namespace search {
+
+	// Default queue policy for a weight type
+	template <class Weight>
+	using DefaultQueue = IndexedPriorityQueue<Weight>;
+
+	/**
+	 * Dijkstra's single source shortest paths from the dense vertex index source.
+	 */
+	template <class Queue, class Adjacency, class Weight>
+	void dijkstra(const Adjacency& graph, unsigned source, BasicSearchContext<Weight>& context) {
+		context.reset(graph.getNumVertex());
+		context.dist[source] = 0;
+		context.touch(source);
+		Queue queue(context.dist, context.queueIndex);
+		queue.insert(source);
+		while (!queue.empty()) {
+			unsigned v = queue.extractMin();
+			Weight dist = context.dist[v];
+			graph.forEachEdge(v, [&](unsigned w, Weight weight) {
+				if (context.dist[w] > dist + weight) {
+					bool queued = context.dist[w] != context.infinity();
+					context.dist[w] = dist + weight;
+					context.path[w] = v;
+					if (!queued) {
+						context.touch(w);
+						queue.insert(w);
+					}
+					else if constexpr (Queue::supportsDecreaseKey)
+						queue.decreaseKey(w);
+					else queue.insert(w);
+				}
+			});
+		}
+	}
+
+	/**
+	 * A* from source to target: Dijkstra ordered by dist + heuristic(v), stopping once target is settled.
+	 * heuristic(v) must be a consistent lower bound of the distance from v to target, so that a settled
+	 * vertex never gets a shorter distance. Returns the number of settled vertices.
+	 */
+	template <class Queue, class Adjacency, class Weight, class Heuristic>
+	size_t astar(const Adjacency& graph, unsigned source, unsigned target, Heuristic heuristic, BasicSearchContext<Weight>& context) {
+		context.reset(graph.getNumVertex());
+		context.dist[source] = 0;
+		context.estimate[source] = heuristic(source);
+		context.touch(source);
+		Queue queue(context.estimate, context.queueIndex);
+		queue.insert(source);
+		size_t settled = 0;
+		while (!queue.empty()) {
+			unsigned v = queue.extractMin();
+			context.visited[v] = true;
+			settled++;
+			if (v == target)
+				break;
+			Weight dist = context.dist[v];
+			graph.forEachEdge(v, [&](unsigned w, Weight weight) {
+				if (!context.visited[w] && context.dist[w] > dist + weight) {
+					bool queued = context.dist[w] != context.infinity();
+					context.dist[w] = dist + weight;
+					context.estimate[w] = dist + weight + heuristic(w);
+					context.path[w] = v;
+					if (!queued) {
+						context.touch(w);
+						queue.insert(w);
+					}
+					else if constexpr (Queue::supportsDecreaseKey)
+						queue.decreaseKey(w);
+					else queue.insert(w);
+				}
+			});
+		}
+		return settled;
+	}
+
+	/**
+	 * Bidirectional search between source and target, alternating a forward search on graph and a backward one on
+	 * reversed, both ordered by dist + potential (the forward potential is potential(v), the backward one
+	 * -potential(v)). A zero potential gives bidirectional Dijkstra; the average of a consistent heuristic towards
+	 * the target and minus one towards the source gives bidirectional A*. Each search settles one vertex at a time
+	 * and the search stops once the keys at the top of both queues add up to at least the best path found.
+	 */
+	template <class Queue, class Adjacency, class Reversed, class Weight, class Potential>
+	void bidirectional(const Adjacency& graph, const Reversed& reversed, unsigned source, unsigned target, Potential potential,
+		BasicBidirectionalContext<Weight>& context) {
+		BasicSearchContext<Weight>* sides[] = { &context.forward, &context.backward };
+		unsigned starts[] = { source, target };
+		Weight sign[] = { 1, -1 };
+		Weight lastKeys[2];	// key of the last vertex settled by each search, a lower bound of the keys still queued
+		context.meeting = -1;
+		context.dist = context.forward.infinity();
+		context.settled = 0;
+		for (int side = 0; side < 2; side++) {
+			sides[side]->reset(graph.getNumVertex());
+			sides[side]->dist[starts[side]] = 0;
+			sides[side]->estimate[starts[side]] = lastKeys[side] = sign[side] * potential(starts[side]);
+			sides[side]->touch(starts[side]);
+		}
+		if (source == target) {
+			context.meeting = source;
+			context.dist = 0;
+			return;
+		}
+		Queue forwardQueue(context.forward.estimate, context.forward.queueIndex);
+		Queue backwardQueue(context.backward.estimate, context.backward.queueIndex);
+		Queue* queues[] = { &forwardQueue, &backwardQueue };
+		forwardQueue.insert(source);
+		backwardQueue.insert(target);
+
+		for (int side = 0; !forwardQueue.empty() && !backwardQueue.empty(); side ^= 1) {
+			BasicSearchContext<Weight>& self = *sides[side];
+			const BasicSearchContext<Weight>& other = *sides[side ^ 1];
+			Queue& queue = *queues[side];
+			unsigned v = queue.extractMin();
+			self.visited[v] = true;
+			context.settled++;
+			lastKeys[side] = self.estimate[v];
+			if (context.dist != context.forward.infinity() && lastKeys[0] + lastKeys[1] >= context.dist)
+				break;
+			Weight dist = self.dist[v];
+			auto relax = [&](unsigned w, Weight weight) {
+				if (self.visited[w] || self.dist[w] <= dist + weight)
+					return;
+				bool queued = self.dist[w] != self.infinity();
+				self.dist[w] = dist + weight;
+				self.estimate[w] = dist + weight + sign[side] * potential(w);
+				self.path[w] = v;
+				if (!queued) {
+					self.touch(w);
+					queue.insert(w);
+				}
+				else if constexpr (Queue::supportsDecreaseKey)
+					queue.decreaseKey(w);
+				else queue.insert(w);
+				if (other.dist[w] != other.infinity() && self.dist[w] + other.dist[w] < context.dist) {
+					context.dist = self.dist[w] + other.dist[w];
+					context.meeting = w;
+				}
+			};
+			if (side == 0)
+				graph.forEachEdge(v, relax);
+			else reversed.forEachEdge(v, relax);
+		}
+	}
+
+	/**
+	 * Breadth first search from source, never entering the vertex skipped (-1 to skip none).
+	 */
+	template <class Adjacency, class Weight>
+	void bfs(const Adjacency& graph, unsigned source, BasicSearchContext<Weight>& context, int skipped = -1) {
+		context.reset(graph.getNumVertex());
+		queue<unsigned> q;
+		context.visited[source] = true;
+		context.touch(source);
+		q.push(source);
+		while (!q.empty()) {
+			unsigned v = q.front();
+			q.pop();
+			graph.forEachEdge(v, [&](unsigned w, Weight) {
+				if (!context.visited[w] && (int)w != skipped) {
+					context.visited[w] = true;
+					context.touch(w);
+					q.push(w);
+				}
+			});
+		}
+	}
+
+	/**
+	 * Prim's minimum spanning tree from vertex 0. Returns the vertices in the order they were added to the tree.
+	 */
+	template <class Queue, class Adjacency, class Weight>
+	vector<unsigned> prim(const Adjacency& graph, BasicSearchContext<Weight>& context) {
+		vector<unsigned> order;
+		context.reset(graph.getNumVertex());
+		if (graph.getNumVertex() == 0)
+			return order;
+		context.dist[0] = 0;
+		context.touch(0);
+		Queue queue(context.dist, context.queueIndex);
+		queue.insert(0);
+		while (!queue.empty()) {
+			unsigned v = queue.extractMin();
+			context.visited[v] = true;
+			order.push_back(v);
+			graph.forEachEdge(v, [&](unsigned w, Weight weight) {
+				if (!context.visited[w] && weight < context.dist[w]) {
+					bool queued = context.dist[w] != context.infinity();
+					context.dist[w] = weight;
+					context.path[w] = v;
+					if (!queued) {
+						context.touch(w);
+						queue.insert(w);
+					}
+					else if constexpr (Queue::supportsDecreaseKey)
+						queue.decreaseKey(w);
+					else queue.insert(w);
+				}
+			});
+		}
+		return order;
+	}
+}
+
+/**
+ * The adjacency of a graph with every edge reversed, for the backward half of a bidirectional search.
+ * The graph must provide forEachIncomingEdge(v, visit), which calls visit(src, weight) for every edge into v.
+ */
+template <class Adjacency>
+class ReversedAdjacency {
+	const Adjacency& graph;
+public:
+	ReversedAdjacency(const Adjacency& graph) : graph(graph) {}
+	size_t getNumVertex() const { return graph.getNumVertex(); }
+
+	template <class Visitor>
+	void forEachEdge(unsigned v, Visitor visit) const { graph.forEachIncomingEdge(v, visit); }
+};
+
+/**
+ * Standalone CSR adjacency with configurable weight and index types, e.g. CSRGraph<unsigned> for a
+ * fixed point (integer weight) search kernel. Build it from a finalized Graph with fromGraph.
+ *
+ * @tparam Weight Type of the edge weights
+ * @tparam Index Type of the vertex indexes and edge offsets
+ */
+template <class Weight, class Index = unsigned>
+class CSRGraph {
+	vector<Index> offsets;
+	vector<Index> targets;
+	vector<Weight> weights;
+public:
+	/**
+	 * Copies the adjacency of a graph, multiplying every weight by scale (rounded when Weight is integral).
+	 */
+	template <class SourceGraph>
+	static CSRGraph fromGraph(const SourceGraph& graph, double scale = 1);
+
+	size_t getNumVertex() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+	size_t getNumEdges() const { return targets.size(); }
+
+	template <class Visitor>
+	void forEachEdge(unsigned v, Visitor visit) const {
+		for (Index e = offsets[v]; e < offsets[v + 1]; e++)
+			visit((unsigned)targets[e], weights[e]);
+	}
+};
+
+template <class Weight, class Index>
+template <class SourceGraph>
+CSRGraph<Weight, Index> CSRGraph<Weight, Index>::fromGraph(const SourceGraph& graph, double scale) {
+	CSRGraph csr;
+	const vector<unsigned>& offsets = graph.getCSROffsets();
+	const vector<unsigned>& targets = graph.getCSRTargets();
+	const vector<double>& weights = graph.getCSRWeights();
+	csr.offsets.assign(offsets.begin(), offsets.end());
+	csr.targets.assign(targets.begin(), targets.end());
+	csr.weights.resize(weights.size());
+	for (size_t e = 0; e < weights.size(); e++) {
+		if constexpr (is_integral<Weight>::value)
+			csr.weights[e] = (Weight)(weights[e] * scale + 0.5);
+		else csr.weights[e] = (Weight)(weights[e] * scale);
+	}
+	return csr;
+}
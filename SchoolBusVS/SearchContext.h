@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+
+#define INF (std::numeric_limits<double>::max)()
+
+using namespace std;
+
+/**
+ * Per-query state of a graph search (Dijkstra, A*, BFS, Prim), indexed by dense vertex index.
+ * Searches only read the Graph, so each thread can run its own queries with its own context.
+ *
+ * @tparam Weight Type of the distances (the weight type of the searched graph)
+ */
+template <class Weight>
+class BasicSearchContext {
+	vector<unsigned> touched;	// vertices whose state was changed by the last search
+public:
+	vector<Weight> dist;
+	vector<int> path;			// dense index of the previous vertex in the path, -1 if none
+	vector<char> visited;
+	vector<unsigned> queueIndex;	// required by IndexedPriorityQueue
+	vector<Weight> estimate;		// dist plus the estimated remaining distance, the queue key of A*
+
+	static constexpr Weight infinity() { return (numeric_limits<Weight>::max)(); }
+
+	/**
+	 * Prepares the context for a new search on a graph with numVertices vertices.
+	 * Only the vertices touched by the previous search are cleared, unless the size changed.
+	 */
+	void reset(size_t numVertices);
+	void touch(unsigned v) { touched.push_back(v); }
+};
+
+typedef BasicSearchContext<double> SearchContext;
+
+/**
+ * State of a bidirectional search: a forward search from the source and a backward one, on the incoming
+ * edges, from the target. The shortest path is the forward path to the meeting vertex followed by the
+ * backward one (backward.path[v] is the next vertex towards the target).
+ */
+template <class Weight>
+struct BasicBidirectionalContext {
+	BasicSearchContext<Weight> forward, backward;
+	int meeting = -1;	// dense index of a vertex of the shortest path, -1 if there's no path
+	Weight dist = BasicSearchContext<Weight>::infinity();
+	size_t settled = 0;	// by both searches
+};
+
+typedef BasicBidirectionalContext<double> BidirectionalContext;
+
+template <class Weight>
+void BasicSearchContext<Weight>::reset(size_t numVertices) {
+	if (dist.size() != numVertices) {
+		dist.assign(numVertices, infinity());
+		path.assign(numVertices, -1);
+		visited.assign(numVertices, false);
+		queueIndex.assign(numVertices, 0);
+		estimate.assign(numVertices, infinity());
+	}
+	else {
+		for (unsigned v : touched) {
+			dist[v] = infinity();
+			path[v] = -1;
+			visited[v] = false;
+			queueIndex[v] = 0;
+			estimate[v] = infinity();
+		}
+	}
+	touched.clear();
+}
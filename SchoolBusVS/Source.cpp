@@ -3,8 +3,15 @@
 #include "Vehicle.h"
 #include "Menu.h"
 #include "VehiclePathCalculator.h"
+#include "Benchmark.h"
+#include "TagIndex.h"
+#include "GraphCatalog.h"
+#include "ArtifactCache.h"
 
 #include <iostream>
+#include <thread>
+#include <future>
+#include <chrono>
 
 #include "PoIList.h"
 #include "graphviewer.h"
@@ -12,6 +19,8 @@
 
 using namespace std;
 
+const size_t CATALOG_MEMORY_BUDGET = 256 << 20;	// bytes of city graphs kept in memory
+
 void displayPath(const vector<Vertex*>& path) {
 	cout << "Path: ";
 	if (path.size() == 0)
@@ -24,12 +33,17 @@ void displayPath(const vector<Vertex*>& path) {
 
 // ------------- GRAPH VIEWER n sei onde pore ------------- //
 
-GraphViewer* createGraphViewer(const Graph* graph, bool enableWeights) {
+// Launches the viewer process and opens its window (the launch alone takes about 2 seconds)
+GraphViewer* openGraphViewer() {
 	GraphViewer* gv = new GraphViewer(600, 600, false);
 	gv->createWindow(600, 600);
 	gv->defineVertexColor("blue");
 	gv->defineEdgeColor("black");
 	gv->defineEdgeCurved(false);
+	return gv;
+}
+
+void showGraph(GraphViewer* gv, const Graph* graph, bool enableWeights) {
 	for (Vertex* vertex : graph->getVertexSet()) {
 		gv->addNode(vertex->getID(), (int)vertex->getX() - 527500, (int)vertex->getY() - 4555555);
 		//gv->addNode(vertex->getID(), (int)vertex->getX(), (int)vertex->getY());
@@ -43,12 +57,17 @@ GraphViewer* createGraphViewer(const Graph* graph, bool enableWeights) {
 		}
 	}
 	gv->rearrange();
+}
+
+GraphViewer* createGraphViewer(const Graph* graph, bool enableWeights) {
+	GraphViewer* gv = openGraphViewer();
+	showGraph(gv, graph, enableWeights);
 	return gv;
 }
 
 void destroyGraphViewer(GraphViewer* gv) {
 	gv->closeWindow();
-	free(gv);
+	delete gv;
 }
 
 void toggleNodeIDs(GraphViewer* gv, const Graph* graph, const vector<int>& poiIDs) {
@@ -78,15 +97,12 @@ void toggleNodeIDs(GraphViewer* gv, const Graph* graph, const vector<int>& poiID
 	gv->rearrange();
 }
 
-void highlightPath(GraphViewer* gv, const vector<Vertex*>& path) {
+void highlightPath(GraphViewer* gv, const Graph* graph, const vector<Vertex*>& path) {
 	for (int i = 0; i < (int)path.size() - 1; i++) {
 		gv->setVertexColor(path[i]->getID(), CYAN);
-		for (Edge* e : path[i]->getAdj()) {
-			if (e->getDest() == path[i + 1]) {
-				gv->setEdgeColor(e->getID(), RED);
-				break;
-			}
-		}
+		Edge* e = graph->findEdge(path[i], path[i + 1]);
+		if (e != NULL)
+			gv->setEdgeColor(e->getID(), RED);
 	}
 	if (path.size() == 0)
 		return;
@@ -98,7 +114,7 @@ void highlightPath(GraphViewer* gv, const vector<Vertex*>& path) {
 }
 
 void highlightPoIs(GraphViewer* gv, const PoIList& pois) {
-	for (POI poi : pois.getPoIs()) {
+	for (const POI& poi : pois.getPoIs()) {
 		switch (poi.getType()) {
 		case POI::Garage: gv->setVertexColor(poi.getID(), LIGHT_GRAY); break;
 		case POI::School: gv->setVertexColor(poi.getID(), RED); break;
@@ -133,8 +149,9 @@ void shortestPathOption(GraphViewer* gv, Graph* graph, const PoIList& poiList, P
 		Menu::getInput<int>("Source ID: ", srcID);
 		Menu::getInput<int>("Destination ID: ", destID);
 
-		displayPath(matrix->getPath(srcID, destID));
-		highlightPath(gv, matrix->getPath(srcID, destID));
+		const vector<Vertex*>& path = matrix->getPath(srcID, destID);
+		displayPath(path);
+		highlightPath(gv, graph, path);
 		cout << "Distance: " << matrix->getDist(srcID, destID) << endl;
 
 		string input;
@@ -145,18 +162,52 @@ void shortestPathOption(GraphViewer* gv, Graph* graph, const PoIList& poiList, P
 	}
 }
 
-void addVehicle(vector<Vehicle*>& vehicles) {
+void cityShortestPath(GraphCatalog& catalog) {
+	Menu::printHeader("Shortest path in another city");
+	cout << "Cities: ";
+	printVector::ofValues(cout, catalog.getCityNames(), " ") << endl;
+
+	string name;
+	Menu::getLineInput("City: ", name);
+	if (!catalog.hasCity(name)) {
+		cout << "Couldn't find city." << endl;
+		return;
+	}
+	shared_ptr<const CityGraph> city = catalog.get(name);
+	if (city == NULL) {
+		cout << "Couldn't load the graph of " << name << endl;
+		return;
+	}
+
+	int srcID, destID;
+	Menu::getInput<int>("Source ID: ", srcID);
+	Menu::getInput<int>("Destination ID: ", destID);
+	Vertex* src = city->graph->findVertex(srcID);
+	Vertex* dest = city->graph->findVertex(destID);
+	if (src == NULL || dest == NULL) {
+		cout << "Couldn't find " << (src == NULL ? "source" : "destination") << " ID." << endl;
+		return;
+	}
+
+	SearchContext context;
+	city->graph->aStarShortestPath(srcID, destID, context);
+	displayPath(city->graph->getPath(dest, context));
+	if (context.dist[dest->getIndex()] != INF)
+		cout << "Distance: " << context.dist[dest->getIndex()] << endl;
+}
+
+void addVehicle(vector<Vehicle>& vehicles) {
 	int capacity;
 	string input;
 	Menu::printHeader("Add vehicle");
 	Menu::getInput<int>("Vehicle capacity (Max. 100): ", capacity, 1, 100);
 	Menu::getLineInput_CI("Do you really wish to add a capacity " + to_string(capacity) + " vehicle? (Y / N) ", input, { "Y","N" });
 	if (input == "Y")
-		vehicles.push_back(new Vehicle(capacity));
+		vehicles.push_back(Vehicle(capacity));
 	else cout << "Operation cancelled" << endl;
 }
 
-void addKid(GraphViewer* gv, Graph* graph, PoIList& poiList, PathMatrix* matrix) {
+void addKid(GraphViewer* gv, Graph* graph, const ArtifactCache& cache, const TagIndex& tags, PoIList& poiList, PathMatrix* matrix) {
 	int homeID, schoolID;
 	string input;
 	Menu::printHeader("Add child record");
@@ -170,8 +221,10 @@ void addKid(GraphViewer* gv, Graph* graph, PoIList& poiList, PathMatrix* matrix)
 	else if (school == NULL)
 		cout << "Couldn't find school ID." << endl;
 	else if (input == "Y") {
-		poiList.addHome(new Child(home, school));
-		*matrix = *graph->multipleDijkstra(poiList.getIDs());
+		if (tags.getNumTags() > 0 && !tags.isSchool(school->getIndex()))
+			Menu::displayColored("Warning: " + to_string(schoolID) + " isn't tagged as a school in the map", MENU_YELLOW) << endl;
+		poiList.addHome(home, school);
+		*matrix = cache.getPathMatrix(*graph, poiList.getIDs());
 		highlightPoIs(gv, poiList);
 	}
 	else cout << "Succesfully cancelled operation" << endl;
@@ -202,7 +255,7 @@ void verifyConnectivity(const vector<int>& ids, PathMatrix* matrix) {
 	else Menu::displayColored("There are " + to_string(missingPaths) + " paths missing.", MENU_LIGHTRED) << endl;
 }
 
-void articulationPoints(GraphViewer* gv, Graph* graph, const PoIList poiList) {
+void articulationPoints(GraphViewer* gv, Graph* graph, const PoIList& poiList) {
 	Menu::printHeader("Articulation Points");
 	vector<Vertex *> articulationPoints = graph->articulationPoints(poiList.getVertices());
 	if (articulationPoints.size() > 0) {
@@ -215,7 +268,27 @@ void articulationPoints(GraphViewer* gv, Graph* graph, const PoIList poiList) {
 	}
 	else Menu::displayColored("There are no articulation Points between PoIs", MENU_LIGHTGREEN) << endl;
 	gv->rearrange();
-	Menu::getLineInput_CI("Do you wish to go back to the main menu? (Y to leave) ", *(new string), { "Y" });	
+	string input;
+	Menu::getLineInput_CI("Do you wish to go back to the main menu? (Y to leave) ", input, { "Y" });	
+	resetGraphColors(gv, graph->getVertexSet(), poiList);
+}
+
+void listSchools(GraphViewer* gv, const Graph* graph, const TagIndex& tags, const PoIList& poiList) {
+	Menu::printHeader("Schools");
+	vector<unsigned> schools = tags.getSchools();
+	if (schools.empty()) {
+		Menu::displayColored("There are no tagged schools in the map", MENU_LIGHTRED) << endl;
+		return;
+	}
+	Menu::displayColored("There are " + to_string(schools.size()) + " schools in the map: ", MENU_WHITE);
+	for (unsigned school : schools) {
+		cout << graph->getVertexSet()[school]->getID() << " ";
+		gv->setVertexColor(graph->getVertexSet()[school]->getID(), MAGENTA);
+	}
+	cout << endl;
+	gv->rearrange();
+	string input;
+	Menu::getLineInput_CI("Do you wish to go back to the main menu? (Y to leave) ", input, { "Y" });
 	resetGraphColors(gv, graph->getVertexSet(), poiList);
 }
 
@@ -227,10 +300,11 @@ void verifyStronglyConnected(Graph* graph) {
 }
 
 
-Graph* makeGraphFromPoIs(const vector<POI>& poiList, PathMatrix* matrix) {
-	Graph* graph = new Graph();
+unique_ptr<Graph> makeGraphFromPoIs(const vector<POI>& poiList, PathMatrix* matrix) {
+	unique_ptr<Graph> graph(new Graph());
+	graph->reserve(poiList.size(), poiList.size() * poiList.size());
 
-	for (POI poi : poiList) {
+	for (const POI& poi : poiList) {
 		graph->addVertex(poi.getID(), poi.getVertex()->getX(), poi.getVertex()->getY());
 	}
 
@@ -284,7 +358,7 @@ vector<Child *> orderKidsMST(vector<POI> poiList, PathMatrix* matrix) {
 			it--;
 		}
 	}
-	Graph* graph = makeGraphFromPoIs(poiList, matrix);
+	unique_ptr<Graph> graph = makeGraphFromPoIs(poiList, matrix);
 	vector<Vertex*> route = graph->calculatePrim();
 
 	for (size_t i = 0; i < route.size(); i++) {
@@ -300,8 +374,8 @@ vector<Child *> orderKidsMST(vector<POI> poiList, PathMatrix* matrix) {
 }
 
 
-void displayVehiclePath(GraphViewer* gv, const PoIList& poiList, const vector<VehiclePathVertex>& path, double dist) {
-	for (VehiclePathVertex v : path) {
+void displayVehiclePath(GraphViewer* gv, const Graph* graph, const PoIList& poiList, const vector<VehiclePathVertex>& path, double dist) {
+	for (const VehiclePathVertex& v : path) {
 		if (!v.isPoI) {
 			Menu::displayColored(to_string(v.vertex->getID()) + " ", MENU_CYAN);
 			continue;
@@ -317,14 +391,15 @@ void displayVehiclePath(GraphViewer* gv, const PoIList& poiList, const vector<Ve
 	Menu::displayColored("Total distance: " + to_string(dist), MENU_WHITE) << endl;
 
 	vector<Vertex*> vertices;
-	for (VehiclePathVertex v : path)
+	vertices.reserve(path.size());
+	for (const VehiclePathVertex& v : path)
 		vertices.push_back(v.vertex);
 
-	highlightPath(gv, vertices);
+	highlightPath(gv, graph, vertices);
 	highlightPoIs(gv, poiList);
 }
 
-void logVehiclePath(ofstream& file, const vector<VehiclePathVertex>& path, string title, double totalDist) {
+void logVehiclePath(ofstream& file, const vector<VehiclePathVertex>& path, const vector<double>& lengths, string title, double totalDist) {
 	file << title << endl;
 	file << "Start at ID: " << path[0].vertex->getID() << endl;
 	for (size_t i = 1; i < path.size(); i++) {
@@ -335,7 +410,7 @@ void logVehiclePath(ofstream& file, const vector<VehiclePathVertex>& path, strin
 		double y2 = path[i].vertex->getY();
 
 		double M_2PI = 2 * 3.14159265358979323846;
-		double dist = sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2));
+		double dist = lengths[i - 1];
 
 		double angle = atan2(y2 - y1, x2 - x1);
 		int octant = lround(8 * angle / M_2PI + 8) % 8;
@@ -359,7 +434,7 @@ void logVehiclePath(ofstream& file, const vector<VehiclePathVertex>& path, strin
 }
 
 
-void pathCalculator(GraphViewer* gv, Graph* graph, const PoIList& poiList, PathMatrix* matrix, const vector<Vehicle*>& vehicles) {
+void pathCalculator(GraphViewer* gv, Graph* graph, const PoIList& poiList, PathMatrix* matrix, vector<Vehicle>& vehicles) {
 	Menu::printHeader("Route Calculator");
 
 	int missingPaths = matrix->getNumMissingPaths(poiList.getIDs(), false);
@@ -372,8 +447,8 @@ void pathCalculator(GraphViewer* gv, Graph* graph, const PoIList& poiList, PathM
 
 	size_t numChildren = poiList.getChildren().size();
 	size_t totalCapacity = 0;
-	for (Vehicle* vehicle : vehicles)
-		totalCapacity += vehicle->getCapacity();
+	for (const Vehicle& vehicle : vehicles)
+		totalCapacity += vehicle.getCapacity();
 	
 	if (numChildren > totalCapacity) {
 		Menu::displayColored("Not enough vehicle space!", MENU_LIGHTRED) << endl;
@@ -387,11 +462,14 @@ void pathCalculator(GraphViewer* gv, Graph* graph, const PoIList& poiList, PathM
 	vector<Child*> orderedKids = orderKidsMST(poiList.getPoIs(), matrix);
 
 	// Algoritmo Greedy
-	vector<Vehicle*> usedVehicles = getUsedVehicles((int)orderedKids.size(), vehicles);
+	vector<Vehicle*> fleet;
+	for (Vehicle& vehicle : vehicles)
+		fleet.push_back(&vehicle);
+	vector<Vehicle*> usedVehicles = getUsedVehicles((int)orderedKids.size(), fleet);
 
 	// Algoritmo Nearest Insertion
-	VehiclePathCalculator* calc = new VehiclePathCalculator(orderedKids, poiList, matrix);
-	calc->calculate(usedVehicles);
+	VehiclePathCalculator calc(orderedKids, poiList, matrix);
+	calc.calculate(usedVehicles);
 
 	for (Vehicle* vehicle : usedVehicles) {
 		Menu::printTitle("Vehicle ID: " + to_string(vehicle->getID()) + " (Capacity: " + to_string(vehicle->getCapacity()) + ")", '-');
@@ -399,13 +477,13 @@ void pathCalculator(GraphViewer* gv, Graph* graph, const PoIList& poiList, PathM
 		double distReturn = vehicle->getReturnDist();
 		// Path
 		Menu::printHeader("Path to school");
-		displayVehiclePath(gv, poiList, vehicle->getPath(), distPath);
+		displayVehiclePath(gv, graph, poiList, vehicle->getPath(), distPath);
 		system("pause");
 		resetGraphColors(gv, graph->getVertexSet(), poiList);
 
 		// Return
 		Menu::printHeader("Path from school (Return)");
-		displayVehiclePath(gv, poiList, vehicle->getReturnPath(), distReturn);		
+		displayVehiclePath(gv, graph, poiList, vehicle->getReturnPath(), distReturn);		
 		system("pause");
 		resetGraphColors(gv, graph->getVertexSet(), poiList);
 
@@ -415,61 +493,128 @@ void pathCalculator(GraphViewer* gv, Graph* graph, const PoIList& poiList, PathM
 		ofstream f2("../Files/vehicle" + to_string(vehicle->getID()) + "Return.txt");
 
 		cout << "Saving path to ../Files/vehicle" << vehicle->getID() << "Go.txt...";
-		logVehiclePath(f1, vehicle->getPath(), "Path", distPath);
+		logVehiclePath(f1, vehicle->getPath(), vehicle->getPathLengths(), "Path", distPath);
 		cout << "Done." << endl;
 
 		cout << "Saving return path to ../Files/vehicle" << vehicle->getID() << "Return.txt... ";
-		logVehiclePath(f2, vehicle->getReturnPath(), "Return Path", distReturn);
+		logVehiclePath(f2, vehicle->getReturnPath(), vehicle->getReturnPathLengths(), "Return Path", distReturn);
 		cout << "Done." << endl;
 
 
 	}
 }
 
+void runBenchmarks() {
+	Menu::printHeader("Benchmarks");
+	for (string city : { "Porto", "Lisboa" }) {
+		string dir = "../Graphs/" + city + "/";
+		benchmark::vertexOrder(cout, dir + "T05_nodes_X_Y_" + city + ".txt", dir + "T05_edges_" + city + ".txt", 100);
+		benchmark::searchKernels(cout, dir + "T05_nodes_X_Y_" + city + ".txt", dir + "T05_edges_" + city + ".txt", 100);
+		benchmark::pointToPoint(cout, dir + "T05_nodes_X_Y_" + city + ".txt", dir + "T05_edges_" + city + ".txt", 100);
+		benchmark::geodesicWeights(cout, dir + "T05_nodes_X_Y_" + city + ".txt", dir + "T05_edges_" + city + ".txt", dir + "T05_nodes_lat_lon_" + city + ".txt");
+	}
+	benchmark::compactGraph(cout, "../Graphs/vportugal.txt", "../Graphs/eportugal.txt", 100);
+	benchmark::snapshot(cout, "../Graphs/vportugal.txt", "../Graphs/eportugal.txt", 100);
+	benchmark::parsingThreads(cout, "../Graphs/vportugal.txt", "../Graphs/eportugal.txt", max(thread::hardware_concurrency(), 1u));
+	benchmark::contractionHierarchy(cout, "../Graphs/vportugal.txt", "../Graphs/eportugal.txt", 1000, max(thread::hardware_concurrency(), 1u));
+	benchmark::manyToMany(cout, "../Graphs/Lisboa/T05_nodes_X_Y_Lisboa.txt", "../Graphs/Lisboa/T05_edges_Lisboa.txt", { 50, 500, 2000 });
+	benchmark::oneToAll(cout, "../Graphs/Lisboa/T05_nodes_X_Y_Lisboa.txt", "../Graphs/Lisboa/T05_edges_Lisboa.txt", 64);
+	benchmark::streamingIngest(cout, "../Graphs/vportugal.txt", "../Graphs/eportugal.txt");
+	for (size_t megabytes : { 16, 128 })
+		benchmark::graphCatalog(cout, "../Graphs", megabytes << 20, 3);
+	benchmark::artifactCache(cout, "../Graphs/Porto/T05_nodes_X_Y_Porto.txt", "../Graphs/Porto/T05_edges_Porto.txt", 30);
+	benchmark::regionOfInterest(cout, "../Graphs/Porto/T05_nodes_X_Y_Porto.txt", "../Graphs/Porto/T05_edges_Porto.txt", "../Files/pois.txt");
+}
+
 /******************************\
 |********* LOAD / SAVE ********|
 \******************************/
 
-void saveVehicles(const vector<Vehicle*>& vehicles) {
+void saveVehicles(const vector<Vehicle>& vehicles) {
 	ofstream f("../Files/vehicles.txt");
 
-	for (Vehicle* vehicle : vehicles) {
-		f << vehicle->getCapacity() << " ";
+	for (const Vehicle& vehicle : vehicles) {
+		f << vehicle.getCapacity() << " ";
 	}
 }
 
-vector<Vehicle*> loadVehicles() {
-	vector<Vehicle*> vehicles;
+vector<Vehicle> loadVehicles() {
+	vector<Vehicle> vehicles;
 	ifstream f("../Files/vehicles.txt");
 
 	int capacity;
 	while (f >> capacity)
-		vehicles.push_back(new Vehicle(capacity));
+		vehicles.push_back(Vehicle(capacity));
 	return vehicles;
 }
 
 
+/******************************\
+|*********** STARTUP **********|
+\******************************/
+
+/**
+ * Result of a startup stage that may still be running in the background, waiting for it on first use.
+ *
+ * @param what Shown while waiting
+ */
+template <class T>
+T& awaitStage(future<T>& stage, T& result, const string& what) {
+	if (stage.valid()) {
+		if (stage.wait_for(chrono::seconds(0)) != future_status::ready)
+			cout << "Waiting for " << what << "..." << endl;
+		result = stage.get();
+	}
+	return result;
+}
+
 int main() {
 	cout << "HELLO WORLD" << endl;
+	auto start = chrono::steady_clock::now();
+
+	// Stages that don't need the graph start right away: the viewer launch sleeps while its process starts
+	cout << "Opening Graph Viewer..." << endl;
+	future<GraphViewer*> viewerLaunch = async(launch::async, openGraphViewer);
+	cout << "Loading vehicles..." << endl;
+	future<vector<Vehicle>> vehiclesLoad = async(launch::async, loadVehicles);
+
 	cout << "Loading Graph..." << endl;
-	Graph* graph = GraphBuilder("../Graphs/nodes.txt", "../Graphs/edges.txt").build();
+	ArtifactCache cache("../Cache");
+	GraphCatalog catalog("../Graphs", CATALOG_MEMORY_BUDGET);
+	catalog.setNumThreads(thread::hardware_concurrency());
+	catalog.setArtifactCache(&cache);
+	shared_ptr<const CityGraph> city = catalog.get("Porto");	// the city of the PoIs file
+	if (city == NULL) {
+		cout << "Couldn't load the Porto graph" << endl;
+		destroyGraphViewer(viewerLaunch.get());
+		return 1;
+	}
+	Graph* graph = city->graph.get();
+	const TagIndex& tags = city->tags;
+	graph->finalize();	// the background stages only read the graph from here on
 
 	cout << "Loading PoIs..." << endl;
 	PoIList poiList("../Files/pois.txt", graph);
 
-	cout << "Pre-processing..." << endl;
-	//auto start = chrono::steady_clock::now();
-	PathMatrix* matrix = graph->multipleDijkstra(poiList.getIDs());
-
-	//auto end = chrono::steady_clock::now();	
-	//cout << chrono::duration_cast<chrono::milliseconds>(end - start).count()  << endl;
-	
-	cout << "Opening Graph Viewer..." << endl;
-	GraphViewer *gv = createGraphViewer(graph, false);
-	highlightPoIs(gv, poiList);
+	// The menu opens now; the options that need these wait for them
+	cout << "Pre-processing (in the background)..." << endl;
+	future<PathMatrix> matrixStage = async(launch::async, [&cache, graph, ids = poiList.getIDs()]() {
+		return cache.getPathMatrix(*graph, ids, thread::hardware_concurrency());
+	});
+	future<GraphViewer*> viewerStage = async(launch::async, [&viewerLaunch, graph, poiList]() {
+		GraphViewer* gv = viewerLaunch.get();
+		showGraph(gv, graph, false);
+		highlightPoIs(gv, poiList);
+		return gv;
+	});
+	PathMatrix matrix;
+	GraphViewer* gv = NULL;
+	auto getMatrix = [&]() { return &awaitStage(matrixStage, matrix, "the pre-processing"); };
+	auto getViewer = [&]() { return awaitStage(viewerStage, gv, "the Graph Viewer"); };
+	vector<Vehicle> vehicles = vehiclesLoad.get();
 
-	cout << "Loading vehicles..." << endl;
-	vector<Vehicle*> vehicles = loadVehicles();
+	auto end = chrono::steady_clock::now();
+	cout << "Ready in " << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
 
 	while (true) {
 		int option;
@@ -484,24 +629,30 @@ int main() {
 		cout << " 8 - Toggle node IDs" << endl;
 		cout << " 9 - Verify Articulation Points" << endl;
 		cout << " 10 - Calculate Bus Route" << endl;
+		cout << " 11 - Run benchmarks" << endl;
+		cout << " 12 - List schools" << endl;
+		cout << " 13 - Shortest path in another city" << endl;
 		cout << " 0 - Save and quit" << endl;
-		Menu::getInput<int>("Option: ", option, 0, 11);
+		Menu::getInput<int>("Option: ", option, 0, 13);
 
 		switch (option) {
-			case 1: shortestPathOption(gv, graph, poiList, matrix); break;
+			case 1: shortestPathOption(getViewer(), graph, poiList, getMatrix()); break;
 			case 2: addVehicle(vehicles); break;
-			case 3: addKid(gv, graph, poiList, matrix); break;
-			case 4: setGarage(gv, graph, poiList, matrix); break;
-			case 5: verifyConnectivity(poiList.getIDs(), matrix); break;
+			case 3: addKid(getViewer(), graph, cache, tags, poiList, getMatrix()); break;
+			case 4: setGarage(getViewer(), graph, poiList, getMatrix()); break;
+			case 5: verifyConnectivity(poiList.getIDs(), getMatrix()); break;
 			case 6:	verifyStronglyConnected(graph); break;
-			case 7: resetGraphColors(gv, graph->getVertexSet(), poiList); break;
-			case 8: toggleNodeIDs(gv, graph, poiList.getIDs()); break;
-			case 9: articulationPoints(gv, graph, poiList); break;
-			case 10: pathCalculator(gv, graph, poiList, matrix, vehicles); break;
+			case 7: resetGraphColors(getViewer(), graph->getVertexSet(), poiList); break;
+			case 8: toggleNodeIDs(getViewer(), graph, poiList.getIDs()); break;
+			case 9: articulationPoints(getViewer(), graph, poiList); break;
+			case 10: pathCalculator(getViewer(), graph, poiList, getMatrix(), vehicles); break;
+			case 11: runBenchmarks(); break;
+			case 12: listSchools(getViewer(), graph, tags, poiList); break;
+			case 13: cityShortestPath(catalog); break;
 			case 0: poiList.save("../Files/pois.txt"); saveVehicles(vehicles); return 0;
 
 		}
 	}
 
-	destroyGraphViewer(gv);
+	destroyGraphViewer(getViewer());
 }
\ No newline at end of file
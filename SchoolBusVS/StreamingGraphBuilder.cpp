@@ -0,0 +1,284 @@
+#include "StreamingGraphBuilder.h"
+#include "ExternalSorter.h"
+#include "GraphFileParser.h"
+#include "GraphSnapshot.h"
+#include <iostream>
+#include <cmath>
+#include <climits>
+
+// Records of the intermediate sorts
+struct NodeLine {
+	int ID;
+	unsigned line;	// position of the node in the file
+	double x, y;
+};
+
+struct IndexedVertex {
+	int ID;
+	unsigned index;	// dense index
+	double x, y;
+};
+
+struct EdgeLine {
+	int srcID, destID;
+	unsigned line;	// position of the edge in the file
+};
+
+struct HalfResolvedEdge {
+	int destID;
+	unsigned line;
+	unsigned srcIndex;
+	double srcX, srcY;
+};
+
+struct ByIDThenLine {
+	bool operator()(const NodeLine& a, const NodeLine& b) const { return a.ID < b.ID || (a.ID == b.ID && a.line < b.line); }
+};
+struct ByLine {
+	bool operator()(const NodeLine& a, const NodeLine& b) const { return a.line < b.line; }
+};
+struct ByID {
+	bool operator()(const IndexedVertex& a, const IndexedVertex& b) const { return a.ID < b.ID; }
+};
+struct BySrcID {
+	bool operator()(const EdgeLine& a, const EdgeLine& b) const { return a.srcID < b.srcID || (a.srcID == b.srcID && a.line < b.line); }
+};
+struct ByDestID {
+	bool operator()(const HalfResolvedEdge& a, const HalfResolvedEdge& b) const { return a.destID < b.destID || (a.destID == b.destID && a.line < b.line); }
+};
+// CSR order; among parallel edges the one with the smallest ID comes first, and is the one kept
+struct BySrcDestID {
+	bool operator()(const EdgeRecord& a, const EdgeRecord& b) const {
+		if (a.srcIndex != b.srcIndex)
+			return a.srcIndex < b.srcIndex;
+		if (a.destIndex != b.destIndex)
+			return a.destIndex < b.destIndex;
+		return a.ID < b.ID;
+	}
+};
+
+// Reads a text file in blocks of whole lines, calling consume(begin, end) for each block
+template <class Consumer>
+static bool forEachBlock(const string& path, size_t blockSize, Consumer consume) {
+	ifstream file(path, ios::binary);
+	if (!file)
+		return false;
+	vector<char> block(blockSize);
+	size_t carried = 0;	// bytes of an incomplete line kept from the previous block
+	while (file) {
+		file.read(block.data() + carried, block.size() - carried);
+		size_t size = carried + (size_t)file.gcount();
+		if (size == 0)
+			break;
+		size_t end = size;
+		if (file) {
+			while (end > 0 && block[end - 1] != '\n')
+				end--;
+			if (end == 0) {	// a line longer than the block
+				block.resize(block.size() * 2);
+				carried = size;
+				continue;
+			}
+		}
+		consume(block.data(), block.data() + end);
+		carried = size - end;
+		copy(block.begin() + end, block.begin() + size, block.begin());
+	}
+	return true;
+}
+
+// Sequential writer of one section of the snapshot, to its own temporary file
+class SectionFile {
+	string path;
+	ofstream file;
+	size_t count = 0;
+public:
+	SectionFile(const string& path) : path(path), file(path, ios::binary | ios::trunc) {}
+	~SectionFile() { file.close(); remove(path.c_str()); }
+	template <class T>
+	void write(const T& value) {
+		file.write((const char*)&value, sizeof(T));
+		count++;
+	}
+	size_t size() const { return count; }
+	// Appends the section, with its padding, to out
+	bool appendTo(ofstream& out, size_t elementSize) {
+		static const char zeros[8] = {};
+		file.close();
+		ifstream in(path, ios::binary);
+		out << in.rdbuf();
+		out.write(zeros, GraphSnapshot::sectionSize(count, elementSize) - count * elementSize);
+		return (bool)out;
+	}
+};
+
+bool StreamingGraphBuilder::build(const string& snapshotPath, unsigned long long sourceKey) const {
+	// At most three sorts are alive at once (two being read, one being filled), each sorter is released once read
+	size_t sortBudget = memoryBudget / 4;
+	size_t blockSize = min<size_t>(max<size_t>(memoryBudget / 8, 4096), 1 << 20);
+	string tmp = snapshotPath + ".tmp";
+
+	// 1. Node lines, sorted by ID to drop the repeated IDs (the first line wins)
+	auto uniqueNodes = make_unique<ExternalSorter<NodeLine, ByLine>>(tmp + ".nodes", sortBudget);
+	{
+		ExternalSorter<NodeLine, ByIDThenLine> nodeLines(tmp + ".nodelines", sortBudget);
+		unsigned line = 0;
+		vector<VertexRecord> records;
+		bool read = forEachBlock(nodeFilePath, blockSize, [&](const char* begin, const char* end) {
+			records.clear();
+			graphfile::parseNodes(begin, end, records);
+			for (const VertexRecord& v : records)
+				nodeLines.add({ v.ID, line++, v.x, v.y });
+		});
+		if (!read) {
+			cout << "Couldn't open node file: " << nodeFilePath << endl;
+			return false;
+		}
+
+		auto reader = nodeLines.read();
+		NodeLine node;
+		bool first = true;
+		int lastID = 0;
+		while (reader.next(node)) {
+			if (first || node.ID != lastID)
+				uniqueNodes->add(node);
+			first = false;
+			lastID = node.ID;
+		}
+	}
+
+	// 2. Unique vertices back in file order: their position is the dense index
+	SectionFile ids(tmp + ".ids"), xs(tmp + ".xs"), ys(tmp + ".ys");
+	auto vertices = make_unique<ExternalSorter<IndexedVertex, ByID>>(tmp + ".vertices", sortBudget);
+	{
+		auto reader = uniqueNodes->read();
+		NodeLine node;
+		unsigned index = 0;
+		while (reader.next(node)) {
+			ids.write(node.ID);
+			xs.write(node.x);
+			ys.write(node.y);
+			vertices->add({ node.ID, index++, node.x, node.y });
+		}
+	}
+	uniqueNodes.reset();
+	size_t numVertices = ids.size();
+
+	// 3. Edge lines, sorted by source ID
+	auto edgeLines = make_unique<ExternalSorter<EdgeLine, BySrcID>>(tmp + ".edgelines", sortBudget);
+	{
+		unsigned line = 0;
+		vector<EdgeIDRecord> records;
+		bool read = forEachBlock(edgeFilePath, blockSize, [&](const char* begin, const char* end) {
+			records.clear();
+			graphfile::parseEdges(begin, end, records);
+			for (const EdgeIDRecord& e : records)
+				edgeLines->add({ e.srcID, e.destID, line++ });
+		});
+		if (!read) {
+			cout << "Couldn't open edge file: " << edgeFilePath << endl;
+			return false;
+		}
+	}
+
+	// Unknown endpoints: the one on the first line is reported, the source before the destination (as GraphBuilder does)
+	unsigned errorLine = UINT_MAX;
+	int errorID = 0;
+	bool errorIsSrc = false;
+	auto reportError = [&](unsigned line, int ID, bool isSrc) {
+		if (line < errorLine || (line == errorLine && isSrc)) {
+			errorLine = line;
+			errorID = ID;
+			errorIsSrc = isSrc;
+		}
+	};
+
+	// 4. Resolve the sources (merge join with the vertices by ID), then sort by destination ID
+	auto halfEdges = make_unique<ExternalSorter<HalfResolvedEdge, ByDestID>>(tmp + ".halfedges", sortBudget);
+	{
+		auto edgeReader = edgeLines->read();
+		auto vertexReader = vertices->read();
+		EdgeLine e;
+		IndexedVertex v;
+		bool hasVertex = vertexReader.next(v);
+		while (edgeReader.next(e)) {
+			while (hasVertex && v.ID < e.srcID)
+				hasVertex = vertexReader.next(v);
+			if (!hasVertex || v.ID != e.srcID)
+				reportError(e.line, e.srcID, true);
+			else halfEdges->add({ e.destID, e.line, v.index, v.x, v.y });
+		}
+	}
+	edgeLines.reset();
+
+	// 5. Resolve the destinations, and emit both directions of every road (IDs 2 * line and 2 * line + 1)
+	ExternalSorter<EdgeRecord, BySrcDestID> edges(tmp + ".edges", sortBudget);
+	{
+		auto edgeReader = halfEdges->read();
+		auto vertexReader = vertices->read();
+		HalfResolvedEdge e;
+		IndexedVertex v;
+		bool hasVertex = vertexReader.next(v);
+		while (edgeReader.next(e)) {
+			while (hasVertex && v.ID < e.destID)
+				hasVertex = vertexReader.next(v);
+			if (!hasVertex || v.ID != e.destID) {
+				reportError(e.line, e.destID, false);
+				continue;
+			}
+			// same formula as geometry::edgeLengths
+			double dx = v.x - e.srcX, dy = v.y - e.srcY;
+			double length = sqrt(dx * dx + dy * dy);
+			edges.add({ e.srcIndex, v.index, (int)(2 * e.line), length });
+			edges.add({ v.index, e.srcIndex, (int)(2 * e.line + 1), length });
+		}
+	}
+	halfEdges.reset();
+	vertices.reset();
+
+	if (errorLine != UINT_MAX) {
+		cout << "Error: Couldn't find vertex with " << (errorIsSrc ? "srcID" : "destID") << " = " << errorID << endl;
+		throw exception();
+	}
+
+	// 6. CSR arrays, in order
+	SectionFile offsets(tmp + ".offsets"), targets(tmp + ".targets"), weights(tmp + ".weights"), edgeIDs(tmp + ".edgeids");
+	{
+		auto reader = edges.read();
+		EdgeRecord e;
+		unsigned src = 0;
+		bool first = true;
+		EdgeRecord last;
+		offsets.write(0u);
+		while (reader.next(e)) {
+			if (!first && e.srcIndex == last.srcIndex && e.destIndex == last.destIndex)
+				continue;	// parallel edge
+			for (; src < e.srcIndex; src++)
+				offsets.write((unsigned)targets.size());
+			targets.write(e.destIndex);
+			weights.write(e.weight);
+			edgeIDs.write(e.ID);
+			first = false;
+			last = e;
+		}
+		for (; src < numVertices; src++)
+			offsets.write((unsigned)targets.size());
+	}
+
+	// 7. Concatenate the sections behind the header
+	{
+		ofstream out(tmp, ios::binary | ios::trunc);
+		GraphSnapshot::Header header = GraphSnapshot::makeHeader(numVertices, targets.size(), sourceKey);
+		out.write((const char*)&header, sizeof(header));
+		bool written = ids.appendTo(out, sizeof(int)) && xs.appendTo(out, sizeof(double)) && ys.appendTo(out, sizeof(double))
+			&& offsets.appendTo(out, sizeof(unsigned)) && targets.appendTo(out, sizeof(unsigned))
+			&& weights.appendTo(out, sizeof(double)) && edgeIDs.appendTo(out, sizeof(int)) && out.flush();
+		if (!written) {
+			out.close();
+			remove(tmp.c_str());
+			return false;
+		}
+	}
+	remove(snapshotPath.c_str());
+	return rename(tmp.c_str(), snapshotPath.c_str()) == 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+using namespace std;
+
+/**
+ * Builds a GraphSnapshot straight from the text files within a fixed memory budget, for graphs too large to be
+ * held as a Graph. The files are read in blocks and every step that needs the whole graph is an external sort
+ * (vertices by ID, edges by endpoint, and finally edges by source), so the CSR arrays are emitted to disk in order.
+ *
+ * The snapshot is the same one GraphSnapshot::write would make of the GraphBuilder graph in InputOrder:
+ * same dense indexes, edge IDs and weights, repeated vertex IDs and parallel edges dropped the same way.
+ */
+class StreamingGraphBuilder {
+	string nodeFilePath;
+	string edgeFilePath;
+	size_t memoryBudget;
+public:
+	/**
+	 * @param memoryBudget Approximate bound, in bytes, of the memory used by build() (at least a few MB)
+	 */
+	StreamingGraphBuilder(string nodeFilePath, string edgeFilePath, size_t memoryBudget)
+		: nodeFilePath(nodeFilePath), edgeFilePath(edgeFilePath), memoryBudget(memoryBudget) {}
+
+	/**
+	 * Writes the snapshot to snapshotPath, using files next to it for the sort runs.
+	 * Returns false if a file couldn't be read or written. Unknown edge endpoints are reported like GraphBuilder does.
+	 */
+	bool build(const string& snapshotPath, unsigned long long sourceKey = 0) const;
+};
@@ -0,0 +1,88 @@
+#include "TagIndex.h"
+#include "GraphFileParser.h"
+#include "MappedFile.h"
+
+TagIndex::TagIndex(const string& path, const Graph& graph) {
+	MappedFile file(path);
+	if (!file.isOpen()) {
+		cout << "Couldn't open tag file: " << path << endl;
+		return;
+	}
+
+	vector<TagRecord> tags;
+	if (!graphfile::parseTags(file.begin(), file.end(), tags)) {
+		cout << "Error: Malformed tag file: " << path << endl;
+		return;
+	}
+	if (tags.size() > MAX_TAGS) {
+		cout << "Warning: only the first " << MAX_TAGS << " tags of " << path << " are indexed" << endl;
+		tags.resize(MAX_TAGS);
+	}
+
+	masks.assign(graph.getNumVertex(), 0);
+	for (unsigned tag = 0; tag < tags.size(); tag++) {
+		vector<unsigned> indexes;
+		indexes.reserve(tags[tag].ids.size());
+		for (int id : tags[tag].ids) {
+			Vertex* v = graph.findVertex(id);
+			if (v != NULL)
+				indexes.push_back(v->getIndex());
+		}
+		sort(indexes.begin(), indexes.end());
+		indexes.erase(unique(indexes.begin(), indexes.end()), indexes.end());
+		indexes.shrink_to_fit();
+		for (unsigned v : indexes)
+			masks[v] |= 1u << tag;
+
+		names.push_back(tags[tag].name);
+		vertices.push_back(move(indexes));
+	}
+	schoolTags = getTagMask({ "amenity=school", "building=school", "school=*" });
+}
+
+int TagIndex::findTag(const string& name) const {
+	for (size_t tag = 0; tag < names.size(); tag++) {
+		if (names[tag] == name)
+			return (int)tag;
+	}
+	return -1;
+}
+
+unsigned TagIndex::getTagMask(const vector<string>& tagNames) const {
+	unsigned mask = 0;
+	for (const string& name : tagNames) {
+		int tag = findTag(name);
+		if (tag >= 0)
+			mask |= 1u << tag;
+	}
+	return mask;
+}
+
+vector<unsigned> TagIndex::getVerticesWithAny(unsigned tagMask) const {
+	vector<unsigned> result;
+	for (unsigned tag = 0; tag < vertices.size(); tag++) {
+		if (((tagMask >> tag) & 1) == 0)
+			continue;
+		if (result.empty()) {
+			result = vertices[tag];
+			continue;
+		}
+		vector<unsigned> merged;
+		merged.reserve(result.size() + vertices[tag].size());
+		set_union(result.begin(), result.end(), vertices[tag].begin(), vertices[tag].end(), back_inserter(merged));
+		result.swap(merged);
+	}
+	return result;
+}
+
+vector<unsigned> TagIndex::getSchools() const {
+	return getVerticesWithAny(schoolTags);
+}
+
+size_t TagIndex::getMemoryUsage() const {
+	size_t bytes = sizeof(TagIndex) + names.capacity() * sizeof(string) + vertices.capacity() * sizeof(vector<unsigned>)
+		+ masks.capacity() * sizeof(unsigned);
+	for (size_t tag = 0; tag < names.size(); tag++)
+		bytes += names[tag].capacity() + vertices[tag].capacity() * sizeof(unsigned);
+	return bytes;
+}
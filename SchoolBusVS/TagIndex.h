@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Graph.h"
+
+using namespace std;
+
+/**
+ * Tags of the vertices of a graph, read from a T05_tags file ("amenity=school", "building=school", ...).
+ * Each tag keeps the sorted dense indexes of its vertices, and each vertex a bitmask of its tags, so
+ * membership tests are O(1) and the vertices of a tag are enumerated without any lookup.
+ * Tagged vertex IDs that aren't in the graph are ignored.
+ */
+class TagIndex {
+public:
+	static const unsigned MAX_TAGS = 32;	// one bit of a tag mask per tag; later tags of the file are dropped
+private:
+	vector<string> names;
+	vector<vector<unsigned>> vertices;	// tag -> sorted dense indexes of its vertices
+	vector<unsigned> masks;				// dense index -> mask of its tags
+	unsigned schoolTags = 0;			// mask of the tags that mark a school
+public:
+	TagIndex() {}
+
+	/**
+	 * Reads the tags of the vertices of graph from the tag file at path. If the file can't be read, the index is empty.
+	 */
+	TagIndex(const string& path, const Graph& graph);
+
+	size_t getNumTags() const { return names.size(); }
+	const string& getTagName(unsigned tag) const { return names[tag]; }
+	int findTag(const string& name) const;	// -1 if there's no such tag
+
+	// Sorted dense indexes of the vertices with the tag
+	const vector<unsigned>& getVertices(unsigned tag) const { return vertices[tag]; }
+
+	bool hasTag(unsigned vertex, unsigned tag) const { return (getTagMask(vertex) >> tag) & 1; }
+	unsigned getTagMask(unsigned vertex) const { return vertex < masks.size() ? masks[vertex] : 0; }
+
+	// Mask of the tags with the given names (names that aren't tags are ignored)
+	unsigned getTagMask(const vector<string>& tagNames) const;
+
+	/**
+	 * Sorted dense indexes of the vertices with any of the tags in tagMask, merged from the tag arrays.
+	 */
+	vector<unsigned> getVerticesWithAny(unsigned tagMask) const;
+
+	/**
+	 * Vertices tagged as a school (amenity=school, building=school or school=*), as sorted dense indexes.
+	 */
+	vector<unsigned> getSchools() const;
+	bool isSchool(unsigned vertex) const { return (getTagMask(vertex) & schoolTags) != 0; }
+
+	size_t getMemoryUsage() const;	// approximate heap usage, in bytes
+};
@@ -0,0 +1,31 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned numThreads) {
+	for (unsigned i = 0; i < numThreads; i++)
+		workers.push_back(thread(&ThreadPool::work, this));
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	available.notify_all();
+	for (thread& worker : workers)
+		worker.join();
+}
+
+void ThreadPool::work() {
+	while (true) {
+		function<void()> task;
+		{
+			unique_lock<mutex> guard(lock);
+			available.wait(guard, [this]() { return stopping || !tasks.empty(); });
+			if (tasks.empty())
+				return;
+			task = move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+using namespace std;
+
+/**
+ * Fixed set of worker threads running queued tasks in submission order.
+ * The destructor lets the queued tasks finish before joining the workers.
+ */
+class ThreadPool {
+	vector<thread> workers;
+	queue<function<void()>> tasks;
+	mutex lock;
+	condition_variable available;
+	bool stopping = false;
+	void work();
+public:
+	ThreadPool(unsigned numThreads);
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	size_t size() const { return workers.size(); }
+
+	/**
+	 * Queues task() and returns a future for its result (or its exception).
+	 */
+	template <class Task>
+	auto submit(Task task) -> future<decltype(task())>;
+
+	/**
+	 * Runs body(i) for every i in [0, count) on the workers and waits for all of them.
+	 * The first exception thrown by a body is rethrown here, once every body has finished.
+	 */
+	template <class Body>
+	void parallelFor(size_t count, Body body);
+};
+
+/**
+ * Runs body(i) for every i in [0, count): on pool (see ThreadPool::parallelFor) if there's one, else on this thread.
+ */
+template <class Body>
+void forEachChunk(ThreadPool* pool, size_t count, Body body);
+
+template <class Task>
+auto ThreadPool::submit(Task task) -> future<decltype(task())> {
+	auto packaged = make_shared<packaged_task<decltype(task())()>>(move(task));
+	future<decltype(task())> result = packaged->get_future();
+	{
+		lock_guard<mutex> guard(lock);
+		tasks.push([packaged]() { (*packaged)(); });
+	}
+	available.notify_one();
+	return result;
+}
+
+template <class Body>
+void ThreadPool::parallelFor(size_t count, Body body) {
+	vector<future<void>> results;
+	results.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		results.push_back(submit([&body, i]() { body(i); }));
+	for (future<void>& result : results)
+		result.wait();
+	for (future<void>& result : results)
+		result.get();
+}
+
+template <class Body>
+void forEachChunk(ThreadPool* pool, size_t count, Body body) {
+	if (pool == NULL) {
+		for (size_t i = 0; i < count; i++)
+			body(i);
+	}
+	else pool->parallelFor(count, body);
+}
@@ -1,4 +1,5 @@
 #include "Vehicle.h"
+#include "Geometry.h"
 
 
 Vehicle::Vehicle(size_t capacity) {
@@ -11,17 +12,17 @@ size_t Vehicle::getCapacity() const
 	return capacity;
 }
 
-vector<Child*> Vehicle::getChildren() const
+const vector<Child*>& Vehicle::getChildren() const
 {
 	return children;
 }
 
-vector<VehiclePathVertex> Vehicle::getPath() const
+const vector<VehiclePathVertex>& Vehicle::getPath() const
 {
 	return path;
 }
 
-vector<VehiclePathVertex> Vehicle::getReturnPath() const
+const vector<VehiclePathVertex>& Vehicle::getReturnPath() const
 {
 	return returnPath;
 }
@@ -31,36 +32,52 @@ int Vehicle::getID() const {
 }
 
 double Vehicle::getPathDist() const {
-	double dist = 0;
-	for (size_t i = 1; i < path.size(); i++) {
-		double x1 = path[i - 1].vertex->getX();
-		double y1 = path[i - 1].vertex->getY();
-
-		double x2 = path[i].vertex->getX();
-		double y2 = path[i].vertex->getY();
-
-		dist += sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2));
-	}
-	return dist;
+	return pathDist;
 }
 
 double Vehicle::getReturnDist() const {
-	double dist = 0;
-	for (size_t i = 1; i < returnPath.size(); i++) {
-		double x1 = returnPath[i - 1].vertex->getX();
-		double y1 = returnPath[i - 1].vertex->getY();
+	return returnDist;
+}
 
-		double x2 = returnPath[i].vertex->getX();
-		double y2 = returnPath[i].vertex->getY();
+const vector<double>& Vehicle::getPathLengths() const {
+	return pathLengths;
+}
+
+const vector<double>& Vehicle::getReturnPathLengths() const {
+	return returnPathLengths;
+}
 
-		dist += sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2));
+// Length of every step of the path. A step along a road is the weight of its edge, which the GraphBuilder
+// already computed (geodesic if the graph has lat/lon coordinates); the others are measured over X/Y in one batch.
+static double computeLengths(const vector<VehiclePathVertex>& path, vector<double>& lengths) {
+	vector<double> xs(path.size()), ys(path.size());
+	for (size_t i = 0; i < path.size(); i++) {
+		xs[i] = path[i].vertex->getX();
+		ys[i] = path[i].vertex->getY();
 	}
+	lengths.assign(path.size() > 1 ? path.size() - 1 : 0, 0);
+	geometry::segmentLengths(xs.data(), ys.data(), path.size(), lengths.data());
+	for (size_t i = 0; i < lengths.size(); i++) {
+		double weight = INF;
+		for (Edge* edge : path[i].vertex->getAdj()) {
+			if (edge->getDest() == path[i + 1].vertex)
+				weight = min(weight, edge->getWeight());
+		}
+		if (weight != INF)
+			lengths[i] = weight;
+	}
+
+	double dist = 0;
+	for (double length : lengths)
+		dist += length;
 	return dist;
 }
 
-void Vehicle::assignPath(const vector<VehiclePathVertex>& path, const vector<VehiclePathVertex>& returnPath) {
-	this->path = path;
-	this->returnPath = returnPath;
+void Vehicle::assignPath(vector<VehiclePathVertex> path, vector<VehiclePathVertex> returnPath) {
+	this->path = move(path);
+	this->returnPath = move(returnPath);
+	this->pathDist = computeLengths(this->path, pathLengths);
+	this->returnDist = computeLengths(this->returnPath, returnPathLengths);
 }
 
 bool Vehicle::operator<(const Vehicle &v) const {
@@ -24,17 +24,22 @@ class Vehicle
 	vector<Child*> children;
 	vector<VehiclePathVertex> path;
 	vector<VehiclePathVertex> returnPath;
+	vector<double> pathLengths;			// length of each step of path, computed when it's assigned
+	vector<double> returnPathLengths;
+	double pathDist = 0, returnDist = 0;
 public:
 	Vehicle(size_t capacity);
 	size_t getCapacity() const;
-	vector<Child*> getChildren() const;
-	vector<VehiclePathVertex> getPath() const;
-	vector<VehiclePathVertex> getReturnPath() const;
+	const vector<Child*>& getChildren() const;
+	const vector<VehiclePathVertex>& getPath() const;
+	const vector<VehiclePathVertex>& getReturnPath() const;
 	int getID() const;
 	double getPathDist() const;
 	double getReturnDist() const;
+	const vector<double>& getPathLengths() const;
+	const vector<double>& getReturnPathLengths() const;
 
-	void assignPath(const vector<VehiclePathVertex>& path, const vector<VehiclePathVertex>& returnPath);
+	void assignPath(vector<VehiclePathVertex> path, vector<VehiclePathVertex> returnPath);
 	bool operator<(const Vehicle &right) const;
 };
 
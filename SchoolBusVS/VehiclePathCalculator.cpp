@@ -14,7 +14,7 @@ VehiclePathCalculator::VehiclePathCalculator(const vector<Child*>& orderedKids,
 }
 
 
-static double getDistIncrease(PathMatrix* matrix, vector<POI> path, int assignedSpot, int newID) {
+static double getDistIncrease(PathMatrix* matrix, const vector<POI>& path, int assignedSpot, int newID) {
 	if (assignedSpot == 0)
 		return matrix->getDist(newID, path[0].getID());
 	if (assignedSpot == path.size())
@@ -51,7 +51,7 @@ void VehiclePathCalculator::assignKidGo(Child* child, vector<POI>& path, PathMat
 }
 
 void VehiclePathCalculator::assignSchoolGo(Vertex* school, vector<POI>& path, PathMatrix* matrix) {
-	for (POI poi : path)
+	for (const POI& poi : path)
 		if (poi.getType() == POI::School && poi.getVertex() == school)
 			return;
 
@@ -91,7 +91,7 @@ void VehiclePathCalculator::assignKidReturn(Child* child, vector<POI>& returnPat
 }
 
 void VehiclePathCalculator::assignSchoolReturn(Vertex* school, vector<POI>& returnPath, PathMatrix* matrix) {
-	for (POI poi : returnPath)
+	for (const POI& poi : returnPath)
 		if (poi.getType() == POI::School && poi.getVertex() == school)
 			return;
 
@@ -143,7 +143,7 @@ void VehiclePathCalculator::assignKids(vector<Child*>& kidsLeft, Vehicle* vehicl
 	// Make vehicle path
 	vector<VehiclePathVertex> fullPath, fullReturnPath;
 	for (int i = 0; i < (int)path.size() - 1; i++) {
-		vector<Vertex*> pathBetweenPoIs = matrix->getPath(path[i].getID(), path[i + 1].getID());
+		const vector<Vertex*>& pathBetweenPoIs = matrix->getPath(path[i].getID(), path[i + 1].getID());
 		fullPath.push_back(VehiclePathVertex(path[i].getVertex(), path[i].getType()));
 		if (pathBetweenPoIs.size() > 2)
 			fullPath.insert(fullPath.end(), pathBetweenPoIs.begin() + 1, pathBetweenPoIs.end() - 1);
@@ -153,7 +153,7 @@ void VehiclePathCalculator::assignKids(vector<Child*>& kidsLeft, Vehicle* vehicl
 		
 	// Make vehicle return path
 	for (int i = 0; i < (int)returnPath.size() - 1; i++) {
-		vector<Vertex*> pathBetweenPoIs = matrix->getPath(returnPath[i].getID(), returnPath[i + 1].getID());
+		const vector<Vertex*>& pathBetweenPoIs = matrix->getPath(returnPath[i].getID(), returnPath[i + 1].getID());
 		fullReturnPath.push_back(VehiclePathVertex(returnPath[i].getVertex(), returnPath[i].getType()));
 		if (pathBetweenPoIs.size() > 2)
 			fullReturnPath.insert(fullReturnPath.end(), pathBetweenPoIs.begin() + 1, pathBetweenPoIs.end() - 1);
@@ -165,5 +165,5 @@ void VehiclePathCalculator::assignKids(vector<Child*>& kidsLeft, Vehicle* vehicl
 		kidsLeft.erase(kidsLeft.begin(), kidsLeft.begin() + vehicle->getCapacity());
 	else kidsLeft.clear();
 
-	vehicle->assignPath(fullPath, fullReturnPath);
+	vehicle->assignPath(move(fullPath), move(fullReturnPath));
 }
\ No newline at end of file
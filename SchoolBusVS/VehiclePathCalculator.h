@@ -7,7 +7,7 @@
 #include "Menu.h"
 class VehiclePathCalculator {
 	const vector<Child*> orderedKids;
-	PoIList poiList;
+	const PoIList& poiList;
 	PathMatrix* matrix;
 public:
 	VehiclePathCalculator(const vector<Child*>& orderedKids, const PoIList& poiList, PathMatrix* matrix);